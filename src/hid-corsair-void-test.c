@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ *  KUnit tests for the Corsair Void report decoding
+ *
+ *  Included by hid-corsair-void.c, so the static helpers can be reached
+ */
+
+#if !IS_ENABLED(CONFIG_KUNIT)
+#error "The Corsair Void tests need a kernel built with CONFIG_KUNIT"
+#endif
+
+#include <kunit/device.h>
+#include <kunit/test.h>
+
+#define CORSAIR_VOID_BENCH_REPORTS		100000
+
+/* Expected mapping for each battery status, with a connected headset */
+struct corsair_void_battery_case {
+	u8 raw_status;
+	int ret;
+	bool present;
+	u8 status;
+	u8 capacity_level;
+	u8 capacity;
+};
+
+static const struct corsair_void_battery_case corsair_void_battery_cases[] = {
+	{ 0, 0, false, POWER_SUPPLY_STATUS_UNKNOWN,
+	  POWER_SUPPLY_CAPACITY_LEVEL_UNKNOWN, 0 },
+	{ CORSAIR_VOID_BATTERY_NORMAL, 0, true, POWER_SUPPLY_STATUS_DISCHARGING,
+	  POWER_SUPPLY_CAPACITY_LEVEL_NORMAL, 80 },
+	{ CORSAIR_VOID_BATTERY_LOW, 0, true, POWER_SUPPLY_STATUS_DISCHARGING,
+	  POWER_SUPPLY_CAPACITY_LEVEL_LOW, 80 },
+	{ CORSAIR_VOID_BATTERY_CRITICAL, 0, true,
+	  POWER_SUPPLY_STATUS_DISCHARGING,
+	  POWER_SUPPLY_CAPACITY_LEVEL_CRITICAL, 80 },
+	{ CORSAIR_VOID_BATTERY_CHARGED, 0, true, POWER_SUPPLY_STATUS_FULL,
+	  POWER_SUPPLY_CAPACITY_LEVEL_NORMAL, 80 },
+	{ CORSAIR_VOID_BATTERY_CHARGING, 0, true, POWER_SUPPLY_STATUS_CHARGING,
+	  POWER_SUPPLY_CAPACITY_LEVEL_NORMAL, 80 },
+	/* Unknown statuses leave the battery unknown */
+	{ 6, -EINVAL, false, POWER_SUPPLY_STATUS_UNKNOWN,
+	  POWER_SUPPLY_CAPACITY_LEVEL_UNKNOWN, 0 },
+};
+
+static void corsair_void_battery_case_desc(const struct corsair_void_battery_case *c,
+					   char *desc)
+{
+	snprintf(desc, KUNIT_PARAM_DESC_SIZE, "battery status %u", c->raw_status);
+}
+
+KUNIT_ARRAY_PARAM(corsair_void_battery, corsair_void_battery_cases,
+		  corsair_void_battery_case_desc);
+
+static void corsair_void_test_decode_battery(struct kunit *test)
+{
+	const struct corsair_void_battery_case *c = test->param_value;
+	struct corsair_void_battery_data battery_data = {};
+
+	KUNIT_EXPECT_EQ(test, corsair_void_decode_battery(&battery_data, 80,
+							  CORSAIR_VOID_WIRELESS_CONNECTED,
+							  c->raw_status),
+			c->ret);
+	KUNIT_EXPECT_EQ(test, (bool)battery_data.present, c->present);
+	KUNIT_EXPECT_EQ(test, battery_data.status, c->status);
+	KUNIT_EXPECT_EQ(test, battery_data.capacity_level, c->capacity_level);
+	KUNIT_EXPECT_EQ(test, battery_data.capacity, c->capacity);
+}
+
+/* Every documented connection status, and whether it means connected */
+struct corsair_void_connection_case {
+	u8 raw_status;
+	bool connected;
+};
+
+static const struct corsair_void_connection_case corsair_void_connection_cases[] = {
+	{ 16, false },
+	{ 38, false },
+	{ 49, false },
+	{ 51, false },
+	{ 52, false },
+	{ CORSAIR_VOID_WIRELESS_CONNECTED, true },
+};
+
+static void corsair_void_connection_case_desc(const struct corsair_void_connection_case *c,
+					      char *desc)
+{
+	snprintf(desc, KUNIT_PARAM_DESC_SIZE, "connection status %u",
+		 c->raw_status);
+}
+
+KUNIT_ARRAY_PARAM(corsair_void_connection, corsair_void_connection_cases,
+		  corsair_void_connection_case_desc);
+
+static void corsair_void_test_decode_connected(struct kunit *test)
+{
+	const struct corsair_void_connection_case *c = test->param_value;
+	struct corsair_void_battery_data battery_data = {};
+
+	KUNIT_EXPECT_EQ(test, corsair_void_decode_connected(c->raw_status, false),
+			c->connected);
+
+	/* Wired headsets are always connected */
+	KUNIT_EXPECT_TRUE(test, corsair_void_decode_connected(c->raw_status, true));
+
+	/* Only a connected wireless headset has a battery */
+	KUNIT_EXPECT_EQ(test, corsair_void_decode_battery(&battery_data, 80,
+							  c->raw_status,
+							  CORSAIR_VOID_BATTERY_NORMAL),
+			0);
+	KUNIT_EXPECT_EQ(test, (bool)battery_data.present, c->connected);
+}
+
+static void corsair_void_test_decode_status(struct kunit *test)
+{
+	struct corsair_void_status_report report;
+	const u8 data[CORSAIR_VOID_REPORT_SIZE] = {
+		CORSAIR_VOID_STATUS_REPORT_ID, 0x80, 0x80 | 42,
+		CORSAIR_VOID_WIRELESS_CONNECTED, CORSAIR_VOID_BATTERY_CHARGING,
+	};
+	const u8 idle[CORSAIR_VOID_REPORT_SIZE] = {
+		CORSAIR_VOID_STATUS_REPORT_ID, 0x7f, 100, 52, 0,
+	};
+
+	corsair_void_decode_status(data, &report);
+	KUNIT_EXPECT_TRUE(test, report.power_button);
+	KUNIT_EXPECT_TRUE(test, report.mic_up);
+	KUNIT_EXPECT_EQ(test, report.capacity, 42);
+	KUNIT_EXPECT_EQ(test, report.connection_status,
+			CORSAIR_VOID_WIRELESS_CONNECTED);
+	KUNIT_EXPECT_EQ(test, report.battery_status,
+			CORSAIR_VOID_BATTERY_CHARGING);
+
+	/* The low bits beside the power button and mic don't leak into them */
+	corsair_void_decode_status(idle, &report);
+	KUNIT_EXPECT_FALSE(test, report.power_button);
+	KUNIT_EXPECT_FALSE(test, report.mic_up);
+	KUNIT_EXPECT_EQ(test, report.capacity, 100);
+	KUNIT_EXPECT_EQ(test, report.connection_status, 52);
+	KUNIT_EXPECT_EQ(test, report.battery_status, 0);
+}
+
+/*
+ * Time the write section of a status report, for a steady connected headset
+ *   Nothing changes after the first report, so no work is queued
+ */
+static void corsair_void_test_bench_status(struct kunit *test)
+{
+	const u8 data[CORSAIR_VOID_REPORT_SIZE] = {
+		CORSAIR_VOID_STATUS_REPORT_ID, 0, 80,
+		CORSAIR_VOID_WIRELESS_CONNECTED, CORSAIR_VOID_BATTERY_NORMAL,
+	};
+	struct corsair_void_status_report report;
+	struct corsair_void_drvdata *drvdata;
+	struct corsair_void_state *state;
+	unsigned long flags;
+	u64 start_ns, elapsed_ns;
+	int i;
+
+	drvdata = kunit_kzalloc(test, sizeof(*drvdata), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, drvdata);
+
+	/* Wired skips the USB wireless status, which needs a real interface */
+	drvdata->dev = kunit_device_register(test, "corsair-void-bench");
+	KUNIT_ASSERT_FALSE(test, IS_ERR(drvdata->dev));
+	drvdata->is_wired = true;
+
+	/* Device managed, so it's freed with the test device */
+	drvdata->stats = devm_alloc_percpu(drvdata->dev,
+					   struct corsair_void_stats);
+	KUNIT_ASSERT_NOT_NULL(test, drvdata->stats);
+
+	seqlock_init(&drvdata->state_lock);
+	spin_lock_init(&drvdata->report_lock);
+	state = &drvdata->state;
+
+	/* Start from the steady state, so the loop doesn't notify */
+	corsair_void_decode_status(data, &report);
+	corsair_void_decode_battery(&state->battery_data, report.capacity,
+				    report.connection_status,
+				    report.battery_status);
+	drvdata->notified_battery = state->battery_data;
+	drvdata->history.status = POWER_SUPPLY_STATUS_UNKNOWN;
+
+	start_ns = ktime_get_ns();
+	for (i = 0; i < CORSAIR_VOID_BENCH_REPORTS; i++) {
+		spin_lock_irqsave(&drvdata->report_lock, flags);
+		write_seqlock(&drvdata->state_lock);
+		corsair_void_decode_status(data, &report);
+		state->mic_up = report.mic_up;
+		state->power_button = report.power_button;
+		state->connected = corsair_void_decode_connected(report.connection_status,
+								 drvdata->is_wired);
+		corsair_void_process_receiver(drvdata, &report);
+		write_sequnlock(&drvdata->state_lock);
+		spin_unlock_irqrestore(&drvdata->report_lock, flags);
+	}
+	elapsed_ns = ktime_get_ns() - start_ns;
+
+	KUNIT_EXPECT_FALSE(test, test_bit(CORSAIR_VOID_BATTERY_CHANGED,
+					  &drvdata->flags));
+	kunit_info(test, "%llu ns/report over %d reports\n",
+		   div_u64(elapsed_ns, CORSAIR_VOID_BENCH_REPORTS),
+		   CORSAIR_VOID_BENCH_REPORTS);
+}
+
+static struct kunit_case corsair_void_test_cases[] = {
+	KUNIT_CASE(corsair_void_test_decode_status),
+	KUNIT_CASE_PARAM(corsair_void_test_decode_connected,
+			 corsair_void_connection_gen_params),
+	KUNIT_CASE_PARAM(corsair_void_test_decode_battery,
+			 corsair_void_battery_gen_params),
+	KUNIT_CASE_SLOW(corsair_void_test_bench_status),
+	{}
+};
+
+static struct kunit_suite corsair_void_test_suite = {
+	.name = "hid-corsair-void",
+	.test_cases = corsair_void_test_cases,
+};
+
+kunit_test_suite(corsair_void_test_suite);
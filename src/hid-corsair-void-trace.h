@@ -0,0 +1,144 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ *  Tracepoints for Corsair Void headsets
+ *
+ *  Copyright (C) 2023-2024 Stuart Hayhurst
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM corsair_void
+
+#if !defined(_HID_CORSAIR_VOID_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _HID_CORSAIR_VOID_TRACE_H
+
+#include <linux/tracepoint.h>
+
+TRACE_DEFINE_ENUM(CORSAIR_VOID_REQUEST_STATUS);
+TRACE_DEFINE_ENUM(CORSAIR_VOID_REQUEST_FIRMWARE);
+TRACE_DEFINE_ENUM(CORSAIR_VOID_REQUEST_SIDETONE);
+TRACE_DEFINE_ENUM(CORSAIR_VOID_REQUEST_ALERT);
+
+#define show_corsair_void_request(type)					\
+	__print_symbolic(type,						\
+			 { CORSAIR_VOID_REQUEST_STATUS, "status" },	\
+			 { CORSAIR_VOID_REQUEST_FIRMWARE, "firmware" },	\
+			 { CORSAIR_VOID_REQUEST_SIDETONE, "sidetone" },	\
+			 { CORSAIR_VOID_REQUEST_ALERT, "alert" })
+
+TRACE_EVENT(corsair_void_request,
+	TP_PROTO(int hid_id, int type, int value, int ret),
+
+	TP_ARGS(hid_id, type, value, ret),
+
+	TP_STRUCT__entry(
+		__field(int, hid_id)
+		__field(int, type)
+		__field(int, value)
+		__field(int, ret)
+	),
+
+	TP_fast_assign(
+		__entry->hid_id = hid_id;
+		__entry->type = type;
+		__entry->value = value;
+		__entry->ret = ret;
+	),
+
+	TP_printk("hid=%d request=%s value=%d ret=%d", __entry->hid_id,
+		  show_corsair_void_request(__entry->type), __entry->value,
+		  __entry->ret)
+);
+
+/* latency_ns is 0 if the report wasn't a reply to a request */
+TRACE_EVENT(corsair_void_status_report,
+	TP_PROTO(int hid_id, bool power_button, bool mic_up, u8 capacity,
+		 u8 connection_status, u8 battery_status, s64 latency_ns),
+
+	TP_ARGS(hid_id, power_button, mic_up, capacity, connection_status,
+		battery_status, latency_ns),
+
+	TP_STRUCT__entry(
+		__field(int, hid_id)
+		__field(bool, power_button)
+		__field(bool, mic_up)
+		__field(u8, capacity)
+		__field(u8, connection_status)
+		__field(u8, battery_status)
+		__field(s64, latency_ns)
+	),
+
+	TP_fast_assign(
+		__entry->hid_id = hid_id;
+		__entry->power_button = power_button;
+		__entry->mic_up = mic_up;
+		__entry->capacity = capacity;
+		__entry->connection_status = connection_status;
+		__entry->battery_status = battery_status;
+		__entry->latency_ns = latency_ns;
+	),
+
+	TP_printk("hid=%d power_button=%d mic_up=%d capacity=%u connection=%u battery=%u latency=%lldns",
+		  __entry->hid_id, __entry->power_button, __entry->mic_up,
+		  __entry->capacity, __entry->connection_status,
+		  __entry->battery_status, __entry->latency_ns)
+);
+
+TRACE_EVENT(corsair_void_firmware_report,
+	TP_PROTO(int hid_id, u8 receiver_major, u8 receiver_minor,
+		 u8 headset_major, u8 headset_minor, s64 latency_ns),
+
+	TP_ARGS(hid_id, receiver_major, receiver_minor, headset_major,
+		headset_minor, latency_ns),
+
+	TP_STRUCT__entry(
+		__field(int, hid_id)
+		__field(u8, receiver_major)
+		__field(u8, receiver_minor)
+		__field(u8, headset_major)
+		__field(u8, headset_minor)
+		__field(s64, latency_ns)
+	),
+
+	TP_fast_assign(
+		__entry->hid_id = hid_id;
+		__entry->receiver_major = receiver_major;
+		__entry->receiver_minor = receiver_minor;
+		__entry->headset_major = headset_major;
+		__entry->headset_minor = headset_minor;
+		__entry->latency_ns = latency_ns;
+	),
+
+	TP_printk("hid=%d receiver=%u.%02u headset=%u.%02u latency=%lldns",
+		  __entry->hid_id, __entry->receiver_major,
+		  __entry->receiver_minor, __entry->headset_major,
+		  __entry->headset_minor, __entry->latency_ns)
+);
+
+TRACE_EVENT(corsair_void_first_battery,
+	TP_PROTO(int hid_id, s64 elapsed_ns),
+
+	TP_ARGS(hid_id, elapsed_ns),
+
+	TP_STRUCT__entry(
+		__field(int, hid_id)
+		__field(s64, elapsed_ns)
+	),
+
+	TP_fast_assign(
+		__entry->hid_id = hid_id;
+		__entry->elapsed_ns = elapsed_ns;
+	),
+
+	TP_printk("hid=%d elapsed=%lldns",
+		  __entry->hid_id, __entry->elapsed_ns)
+);
+
+#endif /* _HID_CORSAIR_VOID_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE hid-corsair-void-trace
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
@@ -71,22 +71,53 @@
 
 #include <linux/bitfield.h>
 #include <linux/bitops.h>
+#include <linux/cache.h>
+#include <linux/circ_buf.h>
 #include <linux/cleanup.h>
+#include <linux/completion.h>
+#include <linux/debugfs.h>
 #include <linux/device.h>
 #include <linux/hid.h>
+#include <linux/fs.h>
+#include <linux/input.h>
+#include <linux/kfifo.h>
+#include <linux/list.h>
+#include <linux/log2.h>
+#include <linux/miscdevice.h>
 #include <linux/module.h>
 #include <linux/mutex.h>
+#include <linux/percpu.h>
+#include <linux/poll.h>
 #include <linux/power_supply.h>
+#include <linux/seq_file.h>
+#include <linux/seqlock.h>
+#include <linux/slab.h>
 #include <linux/usb.h>
+#include <linux/timekeeping.h>
+#include <linux/uaccess.h>
+#include <linux/version.h>
 #include <linux/workqueue.h>
 #include <asm/byteorder.h>
 
 #include "hid-ids.h"
 
-#define CORSAIR_VOID_DEVICE(id, type)		{ HID_USB_DEVICE(USB_VENDOR_ID_CORSAIR, (id)), \
-						.driver_data = (type) }
-#define CORSAIR_VOID_WIRELESS_DEVICE(id)	CORSAIR_VOID_DEVICE((id), CORSAIR_VOID_WIRELESS)
-#define CORSAIR_VOID_WIRED_DEVICE(id)		CORSAIR_VOID_DEVICE((id), CORSAIR_VOID_WIRED)
+/* Older kernels lack the HID wrapper */
+#ifndef hid_warn_ratelimited
+#define hid_warn_ratelimited(hid, fmt, ...)				\
+	dev_warn_ratelimited(&(hid)->dev, fmt, ##__VA_ARGS__)
+#endif
+
+/* Binary attributes only became const in 6.16 */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 16, 0)
+#define CORSAIR_VOID_BIN_ATTR_CONST	const
+#else
+#define CORSAIR_VOID_BIN_ATTR_CONST
+#endif
+
+#define CORSAIR_VOID_DEVICE(id, model)		{ HID_USB_DEVICE(USB_VENDOR_ID_CORSAIR, (id)), \
+						.driver_data = (kernel_ulong_t)&(model) }
+#define CORSAIR_VOID_WIRELESS_DEVICE(id)	CORSAIR_VOID_DEVICE((id), corsair_void_wireless_model)
+#define CORSAIR_VOID_WIRED_DEVICE(id)		CORSAIR_VOID_DEVICE((id), corsair_void_wired_model)
 
 #define CORSAIR_VOID_STATUS_REQUEST_ID		0xC9
 #define CORSAIR_VOID_NOTIF_REQUEST_ID		0xCA
@@ -99,17 +130,97 @@
 #define CORSAIR_VOID_USB_SIDETONE_VALUE		0x200
 #define CORSAIR_VOID_USB_SIDETONE_INDEX		0xB00
 
+#define CORSAIR_VOID_POWER_BUTTON_MASK		GENMASK(7, 7)
 #define CORSAIR_VOID_MIC_MASK			GENMASK(7, 7)
 #define CORSAIR_VOID_CAPACITY_MASK		GENMASK(6, 0)
 
 #define CORSAIR_VOID_WIRELESS_CONNECTED		177
 
+#define CORSAIR_VOID_REPORT_SIZE		5
+
 #define CORSAIR_VOID_SIDETONE_MAX_WIRELESS	55
 #define CORSAIR_VOID_SIDETONE_MAX_WIRED		4096
 
+#define CORSAIR_VOID_SIDETONE_VOLUME_OFFSET	11
+#define CORSAIR_VOID_SIDETONE_VOLUME_BASE	200
+
+/*
+ * Outgoing packets are built in a single preallocated buffer per device
+ *   A whole cacheline is used, so transfers can't share a line with other data
+ */
+#define CORSAIR_VOID_REQUEST_BUF_SIZE		L1_CACHE_BYTES
+
+/*
+ * Requests are sent immediately, and only resent if no reply arrives in time
+ *   Once the retries run out, status requests fall back to the poll interval
+ */
+#define CORSAIR_VOID_REPLY_TIMEOUT_MS		250
+#define CORSAIR_VOID_REQUEST_RETRIES		3
+
+/*
+ * Automatic requests that fail to send back off exponentially, from the reply
+ * timeout up to a maximum, until one succeeds
+ */
+#define CORSAIR_VOID_BACKOFF_MAX_MS		600000U
+
+/* How long lazy firmware reads and refresh writes wait for their reply */
+#define CORSAIR_VOID_REPLY_WAIT_MS		500
+
+/*
+ * Input events for the headset's controls
+ *   KEY_POWER isn't used, as userspace would treat it as the system power button
+ *   Raising the microphone mutes it, so it's reported as a mute switch
+ */
+#define CORSAIR_VOID_POWER_BUTTON_KEY		BTN_0
+#define CORSAIR_VOID_MIC_UP_SWITCH		SW_MUTE_DEVICE
+
+/* Snapshot layout for status_bin, bump the version if it changes */
+#define CORSAIR_VOID_STATUS_BIN_VERSION		1
+#define CORSAIR_VOID_STATUS_CONNECTED		BIT(0)
+#define CORSAIR_VOID_STATUS_MIC_UP		BIT(1)
+#define CORSAIR_VOID_STATUS_BATTERY_PRESENT	BIT(2)
+#define CORSAIR_VOID_STATUS_WIRED		BIT(3)
+#define CORSAIR_VOID_STATUS_SIDETONE_UNKNOWN	0xFFFF
+
+/*
+ * Status request round trip times are bucketed by log2 of microseconds
+ *   Bucket 0 is under 1us, bucket n covers [2^(n - 1), 2^n) us
+ *   The last bucket also counts everything slower
+ */
+#define CORSAIR_VOID_LATENCY_BUCKETS		20
+
+/* Raw report capture ring, the record count must be a power of 2 */
+#define CORSAIR_VOID_CAPTURE_RECORDS		256
+#define CORSAIR_VOID_CAPTURE_DATA_SIZE		16
+
+/* Records buffered for the event device, shared by every device, a power of 2 */
+#define CORSAIR_VOID_EVENT_RECORDS		256
+
+/*
+ * Capacity changes remembered for time to empty estimates
+ *   The oldest and newest samples must be this far apart to give an estimate
+ */
+#define CORSAIR_VOID_HISTORY_SIZE		8
+#define CORSAIR_VOID_HISTORY_MIN_SECS		60
+
+/* Bits for drvdata->flags */
+#define CORSAIR_VOID_BATTERY_CHANGED		0
+
+/* Outgoing request types, for tracepoints */
+enum {
+	CORSAIR_VOID_REQUEST_STATUS,
+	CORSAIR_VOID_REQUEST_FIRMWARE,
+	CORSAIR_VOID_REQUEST_SIDETONE,
+	CORSAIR_VOID_REQUEST_ALERT,
+};
+
+/* Event device record types */
 enum {
-	CORSAIR_VOID_WIRELESS,
-	CORSAIR_VOID_WIRED,
+	CORSAIR_VOID_EVENT_CONNECT	= 1,
+	CORSAIR_VOID_EVENT_DISCONNECT	= 2,
+	CORSAIR_VOID_EVENT_BATTERY	= 3,
+	CORSAIR_VOID_EVENT_MIC		= 4,
+	CORSAIR_VOID_EVENT_POWER_BUTTON	= 5,
 };
 
 enum {
@@ -120,6 +231,85 @@ enum {
 	CORSAIR_VOID_BATTERY_CHARGING	= 5,
 };
 
+#define CREATE_TRACE_POINTS
+#include "hid-corsair-void-trace.h"
+
+/* Packet format to set sidetone for wireless headsets, volume is patched in */
+static const u8 corsair_void_sidetone_packet[] = {
+	CORSAIR_VOID_SIDETONE_REQUEST_ID, 0x0B, 0x00, 0xFF, 0x04, 0x0E,
+	0xFF, 0x05, 0x01, 0x04, 0x00, 0x00,
+};
+
+static_assert(sizeof(corsair_void_sidetone_packet) <= CORSAIR_VOID_REQUEST_BUF_SIZE);
+
+static bool capture_reports;
+module_param(capture_reports, bool, 0444);
+MODULE_PARM_DESC(capture_reports,
+		 "Capture raw reports into a ring buffer, drained through debugfs");
+
+static bool persistent_battery = true;
+module_param(persistent_battery, bool, 0444);
+MODULE_PARM_DESC(persistent_battery,
+		 "Keep the battery registered while no wireless headset is connected");
+
+static unsigned int capacity_hysteresis = 2;
+module_param(capacity_hysteresis, uint, 0644);
+MODULE_PARM_DESC(capacity_hysteresis,
+		 "Smallest capacity change that triggers a battery notification, in percent");
+
+static unsigned int capacity_notify_ms = 30000;
+module_param(capacity_notify_ms, uint, 0644);
+MODULE_PARM_DESC(capacity_notify_ms,
+		 "Minimum time between capacity only battery notifications, in milliseconds");
+
+static bool filter_duplicates = true;
+module_param(filter_duplicates, bool, 0644);
+MODULE_PARM_DESC(filter_duplicates,
+		 "Skip decoding status and firmware reports identical to the last accepted one");
+
+static bool async_sidetone;
+module_param(async_sidetone, bool, 0644);
+MODULE_PARM_DESC(async_sidetone,
+		 "Apply sidetone writes asynchronously, only sending the newest value");
+
+static unsigned int poll_min_ms = 10000;
+module_param(poll_min_ms, uint, 0644);
+MODULE_PARM_DESC(poll_min_ms,
+		 "Battery poll interval while charging or low, in milliseconds");
+
+static unsigned int poll_max_ms = 300000;
+module_param(poll_max_ms, uint, 0644);
+MODULE_PARM_DESC(poll_max_ms,
+		 "Longest battery poll interval while discharging, in milliseconds (0 to disable polling)");
+
+static unsigned int wq_max_active;
+module_param(wq_max_active, uint, 0444);
+MODULE_PARM_DESC(wq_max_active,
+		 "Maximum concurrent work items across all devices (0 for the workqueue default)");
+
+static bool lazy_firmware;
+module_param(lazy_firmware, bool, 0444);
+MODULE_PARM_DESC(lazy_firmware,
+		 "Only request firmware versions when they're read, and keep them across reconnects");
+
+static bool event_device;
+module_param(event_device, bool, 0444);
+MODULE_PARM_DESC(event_device,
+		 "Create /dev/corsair_void, streaming state changes from every device");
+
+static bool autosuspend;
+module_param(autosuspend, bool, 0444);
+MODULE_PARM_DESC(autosuspend,
+		 "Enable USB autosuspend for wireless receivers while no headset is connected");
+
+static bool allow_emulated;
+module_param(allow_emulated, bool, 0444);
+MODULE_PARM_DESC(allow_emulated,
+		 "Also bind wireless receivers emulated through uhid, for the benchmark harness");
+
+/* Deferred work for every device runs here, rather than on system_wq */
+static struct workqueue_struct *corsair_void_wq;
+
 static enum power_supply_property corsair_void_battery_props[] = {
 	POWER_SUPPLY_PROP_STATUS,
 	POWER_SUPPLY_PROP_PRESENT,
@@ -128,91 +318,315 @@ static enum power_supply_property corsair_void_battery_props[] = {
 	POWER_SUPPLY_PROP_SCOPE,
 	POWER_SUPPLY_PROP_MODEL_NAME,
 	POWER_SUPPLY_PROP_MANUFACTURER,
+	POWER_SUPPLY_PROP_TIME_TO_EMPTY_AVG,
 };
 
 struct corsair_void_battery_data {
-	int status;
-	bool present;
+	u8 status;
+	u8 capacity;
+	u8 capacity_level;
+	bool present:1;
+};
+
+/* Decoded status report, see the top of this file for the format */
+struct corsair_void_status_report {
+	bool power_button;
+	bool mic_up;
+	u8 capacity;
+	u8 connection_status;
+	u8 battery_status;
+};
+
+/* State decoded from reports, read through corsair_void_get_state() */
+struct corsair_void_state {
+	struct corsair_void_battery_data battery_data;
+	u8 fw_receiver_major;
+	u8 fw_receiver_minor;
+	u8 fw_headset_major;
+	u8 fw_headset_minor;
+	bool mic_up:1;
+	bool connected:1;
+	bool power_button:1;
+	int time_to_empty;
+};
+
+struct corsair_void_capacity_sample {
+	time64_t time;
 	int capacity;
-	int capacity_level;
 };
 
+/* Ring of capacity changes, while the battery keeps discharging */
+struct corsair_void_capacity_history {
+	struct corsair_void_capacity_sample samples[CORSAIR_VOID_HISTORY_SIZE];
+	unsigned int head;
+	unsigned int count;
+	int status;
+};
+
+/* Fixed layout snapshot, documented in sysfs-driver-hid-corsair-void */
+struct corsair_void_status_bin {
+	u8 version;
+	u8 flags;
+	u8 battery_status;
+	u8 battery_capacity;
+	u8 battery_capacity_level;
+	u8 fw_receiver_major;
+	u8 fw_receiver_minor;
+	u8 fw_headset_major;
+	u8 fw_headset_minor;
+	u8 reserved;
+	__le16 sidetone;
+	__le16 sidetone_max;
+} __packed;
+
+static_assert(sizeof(struct corsair_void_status_bin) == 14);
+
+/* Captured report, as read from debugfs capture and written to inject */
+struct corsair_void_capture_record {
+	__le64 timestamp_ns;
+	u8 size;
+	u8 data[CORSAIR_VOID_CAPTURE_DATA_SIZE];
+	u8 reserved[7];
+} __packed;
+
+static_assert(sizeof(struct corsair_void_capture_record) == 32);
+
+/*
+ * State change, as read from the event device
+ *   Every record carries the full decoded state after the change
+ */
+struct corsair_void_event {
+	__le64 timestamp_ns;
+	__le32 hid_id;
+	u8 type;
+	u8 connected;
+	u8 mic_up;
+	u8 power_button;
+	u8 battery_present;
+	u8 battery_status;
+	u8 battery_capacity;
+	u8 reserved[5];
+} __packed;
+
+static_assert(sizeof(struct corsair_void_event) == 24);
+
+/*
+ * Single producer, single consumer ring of captured reports
+ *   The report path only writes head, the debugfs reader only writes tail
+ *   Reports are dropped rather than overwritten when the ring is full
+ */
+struct corsair_void_capture {
+	struct corsair_void_capture_record *records;
+	unsigned long head;
+	unsigned long tail;
+	atomic_long_t dropped;
+	struct mutex read_mutex;
+};
+
+/*
+ * Backoff for one kind of automatic request
+ *   Only its own work handler updates it, and that never runs concurrently
+ */
+struct corsair_void_backoff {
+	unsigned int failures;
+	unsigned int delay_ms;
+};
+
+/*
+ * Counters exposed through debugfs, per-CPU so counting a report doesn't
+ *   write a shared cacheline
+ */
+struct corsair_void_stats {
+	unsigned long status_reports;
+	unsigned long firmware_reports;
+	unsigned long other_reports;
+	unsigned long unknown_battery_status;
+	unsigned long request_failures;
+	unsigned long connects;
+	unsigned long disconnects;
+	unsigned long battery_notifications;
+	unsigned long duplicate_reports;
+	unsigned long status_latency[CORSAIR_VOID_LATENCY_BUCKETS];
+};
+
+/* Summed as an array of counters */
+static_assert(sizeof(struct corsair_void_stats) % sizeof(unsigned long) == 0);
+
+#define corsair_void_stat_inc(drvdata, field) \
+	this_cpu_inc((drvdata)->stats->field)
+
 struct corsair_void_drvdata {
+	/*
+	 * Everything the report path writes for each report, in one cacheline
+	 *   Readers of the state never block it
+	 *   Statistics are per-CPU, the capture ring is only written once enabled
+	 */
+	struct_group_attr(hot, ____cacheline_aligned,
+		seqlock_t state_lock;
+		struct corsair_void_state state;
+
+		/* Serialises reports, taken before the state lock */
+		spinlock_t report_lock;
+
+		/* Time each request was sent in ns, 0 once the reply has been seen */
+		atomic64_t status_request_ns;
+		atomic64_t firmware_request_ns;
+
+		/* Battery data as of the last queued notification */
+		struct corsair_void_battery_data notified_battery;
+
+		/* Last accepted status payload, a zeroed report ID never matches */
+		u8 last_status[CORSAIR_VOID_REPORT_SIZE];
+	);
+
+	/* Read by the report path, only written during setup */
 	struct hid_device *hid_dev;
 	struct device *dev;
-
+	const struct corsair_void_model *model;
+	bool is_wired:1;
+	bool is_usb:1;
+	bool persistent_battery:1;
+	bool lazy_firmware:1;
+	struct input_dev *input_dev;
+	struct kernfs_node *mic_up_kn;
+	struct kernfs_node *connected_kn;
+
+	/*
+	 * Read by the report path, only written on connects and resumes
+	 *   When the wait for a battery reading started in ns, 0 once seen
+	 *   Last accepted firmware payload, a zeroed report ID never matches
+	 */
+	s64 battery_wait_ns;
+	u8 last_firmware[CORSAIR_VOID_REPORT_SIZE];
+
+	/* Only written when the battery changes */
+	struct corsair_void_capacity_history history;
+	unsigned long flags;
+	unsigned long notified_jiffies;
+
+	struct corsair_void_stats __percpu *stats;
+	struct corsair_void_capture capture;
+
+	/* Cold data, for setup and requests */
 	char *name;
-	bool is_wired;
-	unsigned int sidetone_max;
-
-	struct corsair_void_battery_data battery_data;
-	bool mic_up;
-	bool connected;
-	int fw_receiver_major;
-	int fw_receiver_minor;
-	int fw_headset_major;
-	int fw_headset_minor;
+	struct dentry *debugfs;
 
 	struct power_supply *battery;
 	struct power_supply_desc battery_desc;
 	struct mutex battery_mutex;
 
+	u8 *request_buf;
+	struct mutex request_mutex;
+
+	/* Serialises lazy firmware requests, completed by the 0x66 report */
+	struct mutex firmware_mutex;
+	struct completion firmware_done;
+
+	/*
+	 * Serialises sending refresh requests, numbered by refresh_seq
+	 *   Status reports copy refresh_seq to refresh_done_seq before publishing
+	 */
+	struct mutex refresh_mutex;
+	unsigned long refresh_seq;
+	unsigned long refresh_done_seq;
+	unsigned long refresh_jiffies;
+	bool refresh_sent;
+	wait_queue_head_t refresh_wait;
+
+	int sidetone;
+	int sidetone_target;
+	bool sidetone_stale;
+	struct mutex sidetone_mutex;
+	struct work_struct sidetone_work;
+
+	unsigned int poll_interval_ms;
+	unsigned int status_retries;
+	unsigned int firmware_retries;
+
+	/* Consecutive failures of automatic requests, kept for each kind */
+	struct corsair_void_backoff status_backoff;
+	struct corsair_void_backoff firmware_backoff;
 	struct delayed_work delayed_status_work;
 	struct delayed_work delayed_firmware_work;
 	struct work_struct battery_remove_work;
 	struct work_struct battery_add_work;
+	struct delayed_work battery_changed_work;
+
+	/* Whether a runtime PM reference is held for the connected headset */
+	bool pm_awake;
+
+	/* Whether probe enabled autosuspend, so remove can disable it again */
+	bool autosuspend_enabled;
+	struct work_struct pm_work;
+
+	/* Set by a system suspend, runtime autosuspends leave work running */
+	bool system_suspended;
+
+	/* Entry in corsair_void_devices_list */
+	struct list_head node;
 };
 
 /*
- * Functions to process receiver data
-*/
+ * Checked on common 64 byte cachelines, debug lock options grow the seqlock
+ *   Check the layout with pahole if this fires
+ */
+#if !IS_ENABLED(CONFIG_LOCKDEP) && !IS_ENABLED(CONFIG_DEBUG_SPINLOCK) && \
+	!IS_ENABLED(CONFIG_PREEMPT_RT)
+static_assert(offsetofend(struct corsair_void_drvdata, last_status) -
+	      offsetof(struct corsair_void_drvdata, state_lock) <= 64);
+#endif
+
+/* Behaviour shared by a family of headsets, referenced from the device table */
+struct corsair_void_model {
+	bool is_wired;
+	unsigned int sidetone_max;
 
-static void corsair_void_set_wireless_status(struct corsair_void_drvdata *drvdata)
-{
-	struct usb_interface *usb_if = to_usb_interface(drvdata->dev->parent);
+	/* Template for the sidetone packet, if it's sent as a HID report */
+	const u8 *sidetone_packet;
+	size_t sidetone_packet_size;
 
-	if (drvdata->is_wired)
-		return;
+	int (*set_sidetone)(struct corsair_void_drvdata *drvdata,
+			    unsigned int sidetone);
+	/* NULL if the family can't play alerts */
+	int (*send_alert)(struct corsair_void_drvdata *drvdata, u8 alert_id);
+};
 
-	usb_set_wireless_status(usb_if, drvdata->connected ?
-					USB_WIRELESS_STATUS_CONNECTED :
-					USB_WIRELESS_STATUS_DISCONNECTED);
+/*
+ * Report decoding, these only depend on their arguments
+*/
+
+static void corsair_void_decode_status(const u8 *data,
+				       struct corsair_void_status_report *report)
+{
+	report->power_button = FIELD_GET(CORSAIR_VOID_POWER_BUTTON_MASK, data[1]);
+	report->mic_up = FIELD_GET(CORSAIR_VOID_MIC_MASK, data[2]);
+	report->capacity = FIELD_GET(CORSAIR_VOID_CAPACITY_MASK, data[2]);
+	report->connection_status = data[3];
+	report->battery_status = data[4];
 }
 
-static void corsair_void_set_unknown_batt(struct corsair_void_drvdata *drvdata)
+static bool corsair_void_decode_connected(u8 connection_status, bool is_wired)
 {
-	struct corsair_void_battery_data *battery_data = &drvdata->battery_data;
+	return connection_status == CORSAIR_VOID_WIRELESS_CONNECTED || is_wired;
+}
 
+static void corsair_void_unknown_battery_data(struct corsair_void_battery_data *battery_data)
+{
 	battery_data->status = POWER_SUPPLY_STATUS_UNKNOWN;
 	battery_data->present = false;
 	battery_data->capacity = 0;
 	battery_data->capacity_level = POWER_SUPPLY_CAPACITY_LEVEL_UNKNOWN;
 }
 
-/* Reset data that may change between wireless connections */
-static void corsair_void_set_unknown_wireless_data(struct corsair_void_drvdata *drvdata)
-{
-	/* Only 0 out headset, receiver is always known if relevant */
-	drvdata->fw_headset_major = 0;
-	drvdata->fw_headset_minor = 0;
-
-	drvdata->connected = false;
-	drvdata->mic_up = false;
-
-	corsair_void_set_wireless_status(drvdata);
-}
-
-static void corsair_void_process_receiver(struct corsair_void_drvdata *drvdata,
-					  int raw_battery_capacity,
-					  int raw_connection_status,
-					  int raw_battery_status)
+/*
+ * Map the raw battery fields to power supply values
+ *   Returns -EINVAL for an unknown battery status, leaving the battery unknown
+ */
+static int corsair_void_decode_battery(struct corsair_void_battery_data *battery_data,
+				       u8 raw_battery_capacity,
+				       u8 raw_connection_status,
+				       u8 raw_battery_status)
 {
-	struct corsair_void_battery_data *battery_data = &drvdata->battery_data;
-	struct corsair_void_battery_data orig_battery_data;
-
-	/* Save initial battery data, to compare later */
-	orig_battery_data = *battery_data;
-
 	/* Headset not connected, or it's wired */
 	if (raw_connection_status != CORSAIR_VOID_WIRELESS_CONNECTED)
 		goto unknown_battery;
@@ -244,39 +658,221 @@ static void corsair_void_process_receiver(struct corsair_void_drvdata *drvdata,
 		battery_data->status = POWER_SUPPLY_STATUS_CHARGING;
 		break;
 	default:
-		hid_warn(drvdata->hid_dev, "unknown battery status '%d'",
-			 raw_battery_status);
-		goto unknown_battery;
-		break;
+		corsair_void_unknown_battery_data(battery_data);
+		return -EINVAL;
 	}
 
 	battery_data->capacity = raw_battery_capacity;
-	corsair_void_set_wireless_status(drvdata);
+	return 0;
 
-	goto success;
 unknown_battery:
-	corsair_void_set_unknown_batt(drvdata);
-success:
-
-	/* Inform power supply if battery values changed */
-	if (memcmp(&orig_battery_data, battery_data, sizeof(*battery_data))) {
-		scoped_guard(mutex, &drvdata->battery_mutex) {
-			if (drvdata->battery) {
-				power_supply_changed(drvdata->battery);
-			}
-		}
+	corsair_void_unknown_battery_data(battery_data);
+	return 0;
+}
+
+/*
+ * Functions to process receiver data
+*/
+
+static void corsair_void_set_wireless_status(struct corsair_void_drvdata *drvdata)
+{
+	struct usb_interface *usb_if = to_usb_interface(drvdata->dev->parent);
+
+	if (drvdata->is_wired || !drvdata->is_usb)
+		return;
+
+	usb_set_wireless_status(usb_if, drvdata->state.connected ?
+					USB_WIRELESS_STATUS_CONNECTED :
+					USB_WIRELESS_STATUS_DISCONNECTED);
+}
+
+static void corsair_void_set_unknown_batt(struct corsair_void_drvdata *drvdata)
+{
+	corsair_void_unknown_battery_data(&drvdata->state.battery_data);
+}
+
+/* Reset data that may change between wireless connections */
+static void corsair_void_set_unknown_wireless_data(struct corsair_void_drvdata *drvdata)
+{
+	/* Only 0 out headset, receiver is always known if relevant */
+	/* Lazy firmware versions are kept, to avoid asking again on reconnect */
+	if (!drvdata->lazy_firmware) {
+		drvdata->state.fw_headset_major = 0;
+		drvdata->state.fw_headset_minor = 0;
+	}
+
+	drvdata->state.connected = false;
+	drvdata->state.mic_up = false;
+
+	corsair_void_set_wireless_status(drvdata);
+}
+
+/*
+ * Queue a battery notification, called with state_lock held for writing
+ *   Status, presence and level changes are sent straight away
+ *   Capacity only changes must reach capacity_hysteresis, and are rate limited
+ */
+static void corsair_void_notify_battery(struct corsair_void_drvdata *drvdata)
+{
+	struct corsair_void_battery_data *battery_data = &drvdata->state.battery_data;
+	struct corsair_void_battery_data *notified = &drvdata->notified_battery;
+	unsigned long next_jiffies, delay = 0;
+
+	if (battery_data->status == notified->status &&
+	    battery_data->present == notified->present &&
+	    battery_data->capacity_level == notified->capacity_level) {
+		if (battery_data->capacity == notified->capacity ||
+		    abs(battery_data->capacity - notified->capacity) <
+		    READ_ONCE(capacity_hysteresis))
+			return;
+
+		next_jiffies = READ_ONCE(drvdata->notified_jiffies) +
+			       msecs_to_jiffies(READ_ONCE(capacity_notify_ms));
+		if (time_before(jiffies, next_jiffies))
+			delay = next_jiffies - jiffies;
+	}
+
+	*notified = *battery_data;
+	set_bit(CORSAIR_VOID_BATTERY_CHANGED, &drvdata->flags);
+
+	/* A pending rate limited notification is pulled in, never pushed back */
+	if (delay)
+		queue_delayed_work(corsair_void_wq, &drvdata->battery_changed_work,
+				   delay);
+	else
+		mod_delayed_work(corsair_void_wq, &drvdata->battery_changed_work,
+				 0);
+}
+
+static void corsair_void_reset_history(struct corsair_void_drvdata *drvdata,
+				       int status)
+{
+	/* Avoid dirtying the history for every report while not discharging */
+	if (!drvdata->history.count && drvdata->history.status == status)
+		return;
+
+	drvdata->history.head = 0;
+	drvdata->history.count = 0;
+	drvdata->history.status = status;
+
+	drvdata->state.time_to_empty = -1;
+}
+
+/*
+ * Record capacity changes, and estimate the time to empty from them
+ *   Called with state_lock held for writing
+ *   The rate is taken between the oldest and newest samples, in constant time
+ *   There's no time to full, charging capacities carry an unreliable offset
+ */
+static void corsair_void_update_history(struct corsair_void_drvdata *drvdata)
+{
+	struct corsair_void_battery_data *battery_data = &drvdata->state.battery_data;
+	struct corsair_void_capacity_history *history = &drvdata->history;
+	struct corsair_void_capacity_sample *oldest, *newest;
+	int capacity_delta;
+	time64_t elapsed;
+
+	/* Only a steady discharge gives a usable rate */
+	if (!battery_data->present ||
+	    battery_data->status != POWER_SUPPLY_STATUS_DISCHARGING) {
+		corsair_void_reset_history(drvdata, POWER_SUPPLY_STATUS_UNKNOWN);
+		return;
+	}
+
+	if (history->status != battery_data->status)
+		corsair_void_reset_history(drvdata, battery_data->status);
+
+	/* Only sample capacity changes */
+	newest = &history->samples[(history->head + CORSAIR_VOID_HISTORY_SIZE - 1) %
+				   CORSAIR_VOID_HISTORY_SIZE];
+	if (history->count && newest->capacity == battery_data->capacity)
+		return;
+
+	newest = &history->samples[history->head];
+	newest->time = ktime_get_boottime_seconds();
+	newest->capacity = battery_data->capacity;
+	history->head = (history->head + 1) % CORSAIR_VOID_HISTORY_SIZE;
+	if (history->count < CORSAIR_VOID_HISTORY_SIZE)
+		history->count++;
+
+	oldest = &history->samples[(history->head + CORSAIR_VOID_HISTORY_SIZE -
+				    history->count) % CORSAIR_VOID_HISTORY_SIZE];
+	elapsed = newest->time - oldest->time;
+	capacity_delta = newest->capacity - oldest->capacity;
+	if (elapsed < CORSAIR_VOID_HISTORY_MIN_SECS)
+		return;
+
+	if (capacity_delta < 0)
+		drvdata->state.time_to_empty = div_s64(newest->capacity * elapsed,
+						       -capacity_delta);
+}
+
+/* Called with state_lock held for writing */
+static void corsair_void_process_receiver(struct corsair_void_drvdata *drvdata,
+					  const struct corsair_void_status_report *report)
+{
+	struct corsair_void_battery_data *battery_data = &drvdata->state.battery_data;
+	struct corsair_void_battery_data orig_battery_data;
+
+	/* Save initial battery data, to compare later */
+	orig_battery_data = *battery_data;
+
+	if (corsair_void_decode_battery(battery_data, report->capacity,
+					report->connection_status,
+					report->battery_status)) {
+		corsair_void_stat_inc(drvdata, unknown_battery_status);
+		hid_warn_ratelimited(drvdata->hid_dev,
+				     "unknown battery status '%d'",
+				     report->battery_status);
+	} else if (battery_data->present) {
+		corsair_void_set_wireless_status(drvdata);
 	}
+
+	corsair_void_update_history(drvdata);
+
+	/* Inform power supply if battery values changed, coalescing bursts */
+	if (memcmp(&orig_battery_data, battery_data, sizeof(*battery_data)))
+		corsair_void_notify_battery(drvdata);
 }
 
 /*
  * Functions to report stored data
 */
 
+/* Take a consistent copy of the state, retrying if a report updated it */
+static void corsair_void_get_state(struct corsair_void_drvdata *drvdata,
+				   struct corsair_void_state *state)
+{
+	unsigned int seq;
+
+	do {
+		seq = read_seqbegin(&drvdata->state_lock);
+		*state = drvdata->state;
+	} while (read_seqretry(&drvdata->state_lock, seq));
+}
+
+/* Connected is a bitfield, so it can't be read with READ_ONCE() */
+static bool corsair_void_is_connected(struct corsair_void_drvdata *drvdata)
+{
+	unsigned int seq;
+	bool connected;
+
+	do {
+		seq = read_seqbegin(&drvdata->state_lock);
+		connected = drvdata->state.connected;
+	} while (read_seqretry(&drvdata->state_lock, seq));
+
+	return connected;
+}
+
 static int corsair_void_battery_get_property(struct power_supply *psy,
 					     enum power_supply_property prop,
 					     union power_supply_propval *val)
 {
 	struct corsair_void_drvdata *drvdata = power_supply_get_drvdata(psy);
+	struct corsair_void_state state;
+
+	corsair_void_get_state(drvdata, &state);
 
 	switch (prop) {
 		case POWER_SUPPLY_PROP_SCOPE:
@@ -291,17 +887,22 @@ static int corsair_void_battery_get_property(struct power_supply *psy,
 		case POWER_SUPPLY_PROP_MANUFACTURER:
 			val->strval = "Corsair";
 			break;
+		case POWER_SUPPLY_PROP_TIME_TO_EMPTY_AVG:
+			if (state.time_to_empty < 0)
+				return -ENODATA;
+			val->intval = state.time_to_empty;
+			break;
 		case POWER_SUPPLY_PROP_STATUS:
-			val->intval = drvdata->battery_data.status;
+			val->intval = state.battery_data.status;
 			break;
 		case POWER_SUPPLY_PROP_PRESENT:
-			val->intval = drvdata->battery_data.present;
+			val->intval = state.battery_data.present;
 			break;
 		case POWER_SUPPLY_PROP_CAPACITY:
-			val->intval = drvdata->battery_data.capacity;
+			val->intval = state.battery_data.capacity;
 			break;
 		case POWER_SUPPLY_PROP_CAPACITY_LEVEL:
-			val->intval = drvdata->battery_data.capacity_level;
+			val->intval = state.battery_data.capacity_level;
 			break;
 		default:
 			return -EINVAL;
@@ -314,24 +915,44 @@ static ssize_t microphone_up_show(struct device *dev,
 				  struct device_attribute *attr, char *buf)
 {
 	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
+	struct corsair_void_state state;
 
-	if (!drvdata->connected)
+	corsair_void_get_state(drvdata, &state);
+	if (!state.connected)
 		return -ENODEV;
 
-	return sysfs_emit(buf, "%d\n", drvdata->mic_up);
+	return sysfs_emit(buf, "%d\n", state.mic_up);
+}
+
+static ssize_t connected_show(struct device *dev,
+			      struct device_attribute *attr, char *buf)
+{
+	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
+
+	return sysfs_emit(buf, "%d\n", corsair_void_is_connected(drvdata));
 }
 
+static int corsair_void_fetch_firmware(struct corsair_void_drvdata *drvdata,
+				       bool headset);
+
 static ssize_t fw_version_receiver_show(struct device *dev,
 					struct device_attribute *attr,
 					char *buf)
 {
 	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
+	struct corsair_void_state state;
+	int ret;
+
+	ret = corsair_void_fetch_firmware(drvdata, false);
+	if (ret)
+		return ret;
 
-	if (drvdata->fw_receiver_major == 0 && drvdata->fw_receiver_minor == 0)
+	corsair_void_get_state(drvdata, &state);
+	if (state.fw_receiver_major == 0 && state.fw_receiver_minor == 0)
 		return -ENODATA;
 
-	return sysfs_emit(buf, "%d.%02d\n", drvdata->fw_receiver_major,
-			  drvdata->fw_receiver_minor);
+	return sysfs_emit(buf, "%d.%02d\n", state.fw_receiver_major,
+			  state.fw_receiver_minor);
 }
 
 
@@ -340,12 +961,19 @@ static ssize_t fw_version_headset_show(struct device *dev,
 				       char *buf)
 {
 	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
+	struct corsair_void_state state;
+	int ret;
+
+	ret = corsair_void_fetch_firmware(drvdata, true);
+	if (ret)
+		return ret;
 
-	if (drvdata->fw_headset_major == 0 && drvdata->fw_headset_minor == 0)
+	corsair_void_get_state(drvdata, &state);
+	if (state.fw_headset_major == 0 && state.fw_headset_minor == 0)
 		return -ENODATA;
 
-	return sysfs_emit(buf, "%d.%02d\n", drvdata->fw_headset_major,
-			  drvdata->fw_headset_minor);
+	return sysfs_emit(buf, "%d.%02d\n", state.fw_headset_major,
+			  state.fw_headset_minor);
 }
 
 static ssize_t sidetone_max_show(struct device *dev,
@@ -354,13 +982,139 @@ static ssize_t sidetone_max_show(struct device *dev,
 {
 	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
 
-	return sysfs_emit(buf, "%d\n", drvdata->sidetone_max);
+	return sysfs_emit(buf, "%u\n", drvdata->model->sidetone_max);
+}
+
+static ssize_t sidetone_show(struct device *dev,
+			     struct device_attribute *attr,
+			     char *buf)
+{
+	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
+	int sidetone = READ_ONCE(drvdata->sidetone);
+
+	if (sidetone < 0)
+		return -ENODATA;
+
+	return sysfs_emit(buf, "%d\n", sidetone);
+}
+
+static ssize_t status_show(struct device *dev,
+			   struct device_attribute *attr,
+			   char *buf)
+{
+	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
+	struct corsair_void_battery_data *battery_data;
+	struct corsair_void_state state;
+	int len = 0;
+
+	corsair_void_get_state(drvdata, &state);
+	battery_data = &state.battery_data;
+
+	len += sysfs_emit_at(buf, len, "connected=%d\n", state.connected);
+	len += sysfs_emit_at(buf, len, "microphone_up=%d\n", state.mic_up);
+	len += sysfs_emit_at(buf, len, "battery_present=%d\n",
+			     battery_data->present);
+	len += sysfs_emit_at(buf, len, "battery_status=%d\n",
+			     battery_data->status);
+	len += sysfs_emit_at(buf, len, "battery_capacity=%d\n",
+			     battery_data->capacity);
+	len += sysfs_emit_at(buf, len, "battery_capacity_level=%d\n",
+			     battery_data->capacity_level);
+	len += sysfs_emit_at(buf, len, "fw_version_receiver=%d.%02d\n",
+			     state.fw_receiver_major, state.fw_receiver_minor);
+	len += sysfs_emit_at(buf, len, "fw_version_headset=%d.%02d\n",
+			     state.fw_headset_major, state.fw_headset_minor);
+	len += sysfs_emit_at(buf, len, "sidetone=%d\n",
+			     READ_ONCE(drvdata->sidetone));
+	len += sysfs_emit_at(buf, len, "sidetone_max=%u\n",
+			     drvdata->model->sidetone_max);
+
+	return len;
+}
+
+static ssize_t status_bin_read(struct file *file, struct kobject *kobj,
+			       CORSAIR_VOID_BIN_ATTR_CONST
+			       struct bin_attribute *attr, char *buf,
+			       loff_t off, size_t count)
+{
+	struct corsair_void_drvdata *drvdata = dev_get_drvdata(kobj_to_dev(kobj));
+	struct corsair_void_battery_data *battery_data;
+	struct corsair_void_status_bin status = {};
+	int sidetone = READ_ONCE(drvdata->sidetone);
+	struct corsair_void_state state;
+
+	corsair_void_get_state(drvdata, &state);
+	battery_data = &state.battery_data;
+
+	status.version = CORSAIR_VOID_STATUS_BIN_VERSION;
+	if (state.connected)
+		status.flags |= CORSAIR_VOID_STATUS_CONNECTED;
+	if (state.mic_up)
+		status.flags |= CORSAIR_VOID_STATUS_MIC_UP;
+	if (battery_data->present)
+		status.flags |= CORSAIR_VOID_STATUS_BATTERY_PRESENT;
+	if (drvdata->is_wired)
+		status.flags |= CORSAIR_VOID_STATUS_WIRED;
+
+	status.battery_status = battery_data->status;
+	status.battery_capacity = battery_data->capacity;
+	status.battery_capacity_level = battery_data->capacity_level;
+	status.fw_receiver_major = state.fw_receiver_major;
+	status.fw_receiver_minor = state.fw_receiver_minor;
+	status.fw_headset_major = state.fw_headset_major;
+	status.fw_headset_minor = state.fw_headset_minor;
+
+	status.sidetone = cpu_to_le16(sidetone < 0 ?
+				      CORSAIR_VOID_STATUS_SIDETONE_UNKNOWN :
+				      sidetone);
+	status.sidetone_max = cpu_to_le16(drvdata->model->sidetone_max);
+
+	return memory_read_from_buffer(buf, count, &off, &status,
+				       sizeof(status));
 }
 
 /*
  * Functions to send data to headset
 */
 
+/* Wake the receiver for a request, it can autosuspend again once put */
+static int corsair_void_power_get(struct corsair_void_drvdata *drvdata)
+{
+	return hid_hw_power(drvdata->hid_dev, PM_HINT_FULLON);
+}
+
+static void corsair_void_power_put(struct corsair_void_drvdata *drvdata)
+{
+	hid_hw_power(drvdata->hid_dev, PM_HINT_NORMAL);
+}
+
+/* Whether the USB device's power/control already allows autosuspend */
+static bool corsair_void_autosuspend_allowed(struct usb_device *usb_dev)
+{
+#ifdef CONFIG_PM
+	return usb_dev->dev.power.runtime_auto;
+#else
+	return false;
+#endif
+}
+
+static int corsair_void_send_alert_wireless(struct corsair_void_drvdata *drvdata,
+					    u8 alert_id)
+{
+	u8 *send_buf = drvdata->request_buf;
+
+	guard(mutex)(&drvdata->request_mutex);
+
+	/* Packet format to send alert with ID alert_id */
+	send_buf[0] = CORSAIR_VOID_NOTIF_REQUEST_ID;
+	send_buf[1] = 0x02;
+	send_buf[2] = alert_id;
+
+	return hid_hw_raw_request(drvdata->hid_dev, CORSAIR_VOID_NOTIF_REQUEST_ID,
+				  send_buf, 3, HID_OUTPUT_REPORT,
+				  HID_REQ_SET_REPORT);
+}
+
 static ssize_t send_alert_store(struct device *dev,
 				struct device_attribute *attr,
 				const char *buf, size_t count)
@@ -368,84 +1122,119 @@ static ssize_t send_alert_store(struct device *dev,
 	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
 	struct hid_device *hid_dev = drvdata->hid_dev;
 	unsigned char alert_id;
-	unsigned char *send_buf __free(kfree) = NULL;
 	int ret;
 
-	if (!drvdata->connected || drvdata->is_wired)
+	if (!corsair_void_is_connected(drvdata) || !drvdata->model->send_alert)
 		return -ENODEV;
 
 	/* Only accept 0 or 1 for alert ID */
 	if (kstrtou8(buf, 10, &alert_id) || alert_id >= 2)
 		return -EINVAL;
 
-	send_buf = kmalloc(3, GFP_KERNEL);
-	if (!send_buf)
-		return -ENOMEM;
+	ret = corsair_void_power_get(drvdata);
+	if (ret >= 0) {
+		ret = drvdata->model->send_alert(drvdata, alert_id);
+		corsair_void_power_put(drvdata);
+	}
 
-	/* Packet format to send alert with ID alert_id */
-	send_buf[0] = CORSAIR_VOID_NOTIF_REQUEST_ID;
-	send_buf[1] = 0x02;
-	send_buf[2] = alert_id;
+	trace_corsair_void_request(hid_dev->id, CORSAIR_VOID_REQUEST_ALERT,
+				   alert_id, ret);
 
-	ret = hid_hw_raw_request(hid_dev, CORSAIR_VOID_NOTIF_REQUEST_ID,
-				 send_buf, 3, HID_OUTPUT_REPORT,
-				 HID_REQ_SET_REPORT);
-	if (ret < 0)
-		hid_warn(hid_dev, "failed to send alert request (reason: %d)",
-			 ret);
-	else
+	if (ret < 0) {
+		corsair_void_stat_inc(drvdata, request_failures);
+		hid_warn_ratelimited(hid_dev,
+				     "failed to send alert request (reason: %d)",
+				     ret);
+	} else {
 		ret = count;
+	}
 
 	return ret;
 }
 
-static int corsair_void_set_sidetone_wired(struct device *dev, const char *buf,
+static int corsair_void_set_sidetone_wired(struct corsair_void_drvdata *drvdata,
 					   unsigned int sidetone)
 {
-	struct usb_interface *usb_if = to_usb_interface(dev->parent);
+	struct usb_interface *usb_if = to_usb_interface(drvdata->dev->parent);
 	struct usb_device *usb_dev = interface_to_usbdev(usb_if);
+	__le16 *sidetone_le = (__le16 *)drvdata->request_buf;
+	int ret;
+
+	guard(mutex)(&drvdata->request_mutex);
 
 	/* Packet format to set sidetone for wired headsets */
-	__le16 sidetone_le = cpu_to_le16(sidetone);
+	*sidetone_le = cpu_to_le16(sidetone);
+
+	ret = usb_control_msg(usb_dev, usb_sndctrlpipe(usb_dev, 0),
+			      CORSAIR_VOID_USB_SIDETONE_REQUEST,
+			      CORSAIR_VOID_USB_SIDETONE_REQUEST_TYPE,
+			      CORSAIR_VOID_USB_SIDETONE_VALUE,
+			      CORSAIR_VOID_USB_SIDETONE_INDEX,
+			      sidetone_le, sizeof(*sidetone_le),
+			      USB_CTRL_SET_TIMEOUT);
+	if (ret < 0)
+		return ret;
 
-	return usb_control_msg_send(usb_dev, 0,
-				   CORSAIR_VOID_USB_SIDETONE_REQUEST,
-				   CORSAIR_VOID_USB_SIDETONE_REQUEST_TYPE,
-				   CORSAIR_VOID_USB_SIDETONE_VALUE,
-				   CORSAIR_VOID_USB_SIDETONE_INDEX,
-				   &sidetone_le, 2, USB_CTRL_SET_TIMEOUT,
-				   GFP_KERNEL);
+	return ret == sizeof(*sidetone_le) ? 0 : -EREMOTEIO;
 }
 
-static int corsair_void_set_sidetone_wireless(struct device *dev,
-					      const char *buf,
-					      unsigned char sidetone)
+static int corsair_void_set_sidetone_wireless(struct corsair_void_drvdata *drvdata,
+					      unsigned int sidetone)
 {
-	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
+	const struct corsair_void_model *model = drvdata->model;
 	struct hid_device *hid_dev = drvdata->hid_dev;
-	unsigned char *send_buf __free(kfree) = NULL;
+	u8 *send_buf = drvdata->request_buf;
 
-	send_buf = kmalloc(12, GFP_KERNEL);
-	if (!send_buf)
-		return -ENOMEM;
+	guard(mutex)(&drvdata->request_mutex);
 
-	/* Packet format to set sidetone for wireless headsets */
-	send_buf[0] = CORSAIR_VOID_SIDETONE_REQUEST_ID;
-	send_buf[1] = 0x0B;
-	send_buf[2] = 0x00;
-	send_buf[3] = 0xFF;
-	send_buf[4] = 0x04;
-	send_buf[5] = 0x0E;
-	send_buf[6] = 0xFF;
-	send_buf[7] = 0x05;
-	send_buf[8] = 0x01;
-	send_buf[9] = 0x04;
-	send_buf[10] = 0x00;
-	send_buf[11] = sidetone + 200;
+	memcpy(send_buf, model->sidetone_packet, model->sidetone_packet_size);
+	send_buf[CORSAIR_VOID_SIDETONE_VOLUME_OFFSET] =
+		sidetone + CORSAIR_VOID_SIDETONE_VOLUME_BASE;
 
 	return hid_hw_raw_request(hid_dev, CORSAIR_VOID_SIDETONE_REQUEST_ID,
-				  send_buf, 12, HID_FEATURE_REPORT,
-				  HID_REQ_SET_REPORT);
+				  send_buf, model->sidetone_packet_size,
+				  HID_FEATURE_REPORT, HID_REQ_SET_REPORT);
+}
+
+static int corsair_void_set_sidetone(struct corsair_void_drvdata *drvdata,
+				     unsigned int sidetone)
+{
+	int ret;
+
+	ret = corsair_void_power_get(drvdata);
+	if (ret < 0)
+		goto out;
+
+	ret = drvdata->model->set_sidetone(drvdata, sidetone);
+	corsair_void_power_put(drvdata);
+
+out:
+	trace_corsair_void_request(drvdata->hid_dev->id,
+				   CORSAIR_VOID_REQUEST_SIDETONE, sidetone, ret);
+	if (ret < 0)
+		corsair_void_stat_inc(drvdata, request_failures);
+
+	return ret;
+}
+
+/* Send sidetone, unless it's already been applied to the current headset */
+static int corsair_void_apply_sidetone(struct corsair_void_drvdata *drvdata,
+				       unsigned int sidetone)
+{
+	int ret;
+
+	guard(mutex)(&drvdata->sidetone_mutex);
+	if (!drvdata->sidetone_stale && drvdata->sidetone == sidetone)
+		return 0;
+
+	ret = corsair_void_set_sidetone(drvdata, sidetone);
+	if (ret < 0)
+		return ret;
+
+	WRITE_ONCE(drvdata->sidetone, sidetone);
+	drvdata->sidetone_stale = false;
+
+	return 0;
 }
 
 static ssize_t set_sidetone_store(struct device *dev,
@@ -457,20 +1246,27 @@ static ssize_t set_sidetone_store(struct device *dev,
 	unsigned int sidetone;
 	int ret;
 
-	if (!drvdata->connected)
+	if (!corsair_void_is_connected(drvdata))
 		return -ENODEV;
 
-	/* sidetone must be between 0 and drvdata->sidetone_max inclusive */
-	if (kstrtouint(buf, 10, &sidetone) || sidetone > drvdata->sidetone_max)
+	/* sidetone must be between 0 and the model's sidetone_max inclusive */
+	if (kstrtouint(buf, 10, &sidetone) ||
+	    sidetone > drvdata->model->sidetone_max)
 		return -EINVAL;
 
-	if (drvdata->is_wired)
-		ret = corsair_void_set_sidetone_wired(dev, buf, sidetone);
-	else
-		ret = corsair_void_set_sidetone_wireless(dev, buf, sidetone);
+	/* Remembered, so it can be replayed when a headset connects */
+	WRITE_ONCE(drvdata->sidetone_target, sidetone);
+
+	/* Let the work handler send the newest value, dropping older ones */
+	if (async_sidetone) {
+		queue_work(corsair_void_wq, &drvdata->sidetone_work);
+		return count;
+	}
 
+	ret = corsair_void_apply_sidetone(drvdata, sidetone);
 	if (ret < 0)
-		hid_warn(hid_dev, "failed to send sidetone (reason: %d)", ret);
+		hid_warn_ratelimited(hid_dev,
+				     "failed to send sidetone (reason: %d)", ret);
 	else
 		ret = count;
 
@@ -479,48 +1275,280 @@ static ssize_t set_sidetone_store(struct device *dev,
 
 static int corsair_void_request_status(struct hid_device *hid_dev, int id)
 {
-	unsigned char *send_buf __free(kfree) = NULL;
+	struct corsair_void_drvdata *drvdata = hid_get_drvdata(hid_dev);
+	u8 *send_buf = drvdata->request_buf;
+	atomic64_t *request_ns;
+	int ret, type;
+
+	if (id == CORSAIR_VOID_STATUS_REPORT_ID) {
+		request_ns = &drvdata->status_request_ns;
+		type = CORSAIR_VOID_REQUEST_STATUS;
+	} else {
+		request_ns = &drvdata->firmware_request_ns;
+		type = CORSAIR_VOID_REQUEST_FIRMWARE;
+	}
 
-	send_buf = kmalloc(2, GFP_KERNEL);
-	if (!send_buf)
-		return -ENOMEM;
+	ret = corsair_void_power_get(drvdata);
+	if (ret < 0) {
+		corsair_void_stat_inc(drvdata, request_failures);
+		goto out;
+	}
 
-	/* Packet format to request data item (status / firmware) refresh */
-	send_buf[0] = CORSAIR_VOID_STATUS_REQUEST_ID;
-	send_buf[1] = id;
+	scoped_guard(mutex, &drvdata->request_mutex) {
+		/* Packet format to request data item (status / firmware) refresh */
+		send_buf[0] = CORSAIR_VOID_STATUS_REQUEST_ID;
+		send_buf[1] = id;
+
+		/* Send request for data refresh, timestamped before the reply can arrive */
+		atomic64_set(request_ns, ktime_get_ns());
+		ret = hid_hw_raw_request(hid_dev, CORSAIR_VOID_STATUS_REQUEST_ID,
+					 send_buf, 2, HID_OUTPUT_REPORT,
+					 HID_REQ_SET_REPORT);
+		if (ret < 0) {
+			atomic64_set(request_ns, 0);
+			corsair_void_stat_inc(drvdata, request_failures);
+		}
+	}
+	corsair_void_power_put(drvdata);
 
-	/* Send request for data refresh */
-	return hid_hw_raw_request(hid_dev, CORSAIR_VOID_STATUS_REQUEST_ID,
-				  send_buf, 2, HID_OUTPUT_REPORT,
-				  HID_REQ_SET_REPORT);
+out:
+	trace_corsair_void_request(hid_dev->id, type, id, ret);
+	return ret;
+}
+
+/*
+ * In lazy mode, request the firmware versions if none are cached yet
+ *   Waits a bounded time for the reply, concurrent readers share the request
+ */
+static int corsair_void_fetch_firmware(struct corsair_void_drvdata *drvdata,
+				       bool headset)
+{
+	struct corsair_void_state state;
+	long remaining;
+	int ret;
+
+	if (!drvdata->lazy_firmware)
+		return 0;
+
+	guard(mutex)(&drvdata->firmware_mutex);
+	corsair_void_get_state(drvdata, &state);
+	if (headset) {
+		/* A disconnected wireless headset can't answer */
+		if (state.fw_headset_major || state.fw_headset_minor ||
+		    (!state.connected && !drvdata->is_wired))
+			return 0;
+	} else if (state.fw_receiver_major || state.fw_receiver_minor) {
+		return 0;
+	}
+
+	reinit_completion(&drvdata->firmware_done);
+	ret = corsair_void_request_status(drvdata->hid_dev,
+					  CORSAIR_VOID_FIRMWARE_REPORT_ID);
+	if (ret < 0)
+		return ret;
+
+	remaining = wait_for_completion_interruptible_timeout(&drvdata->firmware_done,
+							      msecs_to_jiffies(CORSAIR_VOID_REPLY_WAIT_MS));
+	if (remaining < 0)
+		return remaining;
+
+	return remaining ? 0 : -ETIMEDOUT;
+}
+
+/* Whether a status report has been published since refresh seq was taken */
+static bool corsair_void_refresh_seen(struct corsair_void_drvdata *drvdata,
+				      unsigned long seq)
+{
+	return (long)(smp_load_acquire(&drvdata->refresh_done_seq) - seq) >= 0;
+}
+
+/*
+ * Request fresh status, and wait for the reply
+ *   Callers arriving while a request is in flight wait for the same reply
+ *   Each request takes a new sequence number, so a report published before
+ *   it can never answer it
+ */
+static int corsair_void_refresh(struct corsair_void_drvdata *drvdata)
+{
+	unsigned long wait = msecs_to_jiffies(CORSAIR_VOID_REPLY_WAIT_MS);
+	unsigned long seq;
+	long remaining;
+	int ret;
+
+	scoped_guard(mutex, &drvdata->refresh_mutex) {
+		seq = drvdata->refresh_seq;
+
+		/* Send a new request, unless one is in flight and not overdue */
+		if (!drvdata->refresh_sent ||
+		    corsair_void_refresh_seen(drvdata, seq) ||
+		    time_after(jiffies, drvdata->refresh_jiffies + wait)) {
+			seq++;
+			WRITE_ONCE(drvdata->refresh_seq, seq);
+			drvdata->refresh_jiffies = jiffies;
+
+			ret = corsair_void_request_status(drvdata->hid_dev,
+							  CORSAIR_VOID_STATUS_REPORT_ID);
+			drvdata->refresh_sent = ret >= 0;
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	remaining = wait_event_interruptible_timeout(drvdata->refresh_wait,
+						     corsair_void_refresh_seen(drvdata, seq),
+						     wait);
+	if (remaining < 0)
+		return remaining;
+
+	return remaining ? 0 : -ETIMEDOUT;
+}
+
+static ssize_t refresh_store(struct device *dev,
+			     struct device_attribute *attr,
+			     const char *buf, size_t count)
+{
+	struct corsair_void_drvdata *drvdata = dev_get_drvdata(dev);
+	bool refresh;
+	int ret;
+
+	if (kstrtobool(buf, &refresh) || !refresh)
+		return -EINVAL;
+
+	ret = corsair_void_refresh(drvdata);
+	if (ret < 0)
+		return ret;
+
+	return count;
 }
 
 /*
  * Headset connect / disconnect handlers and work handlers
 */
 
+/* Pick the next poll interval, 0 if the headset shouldn't be polled */
+static void corsair_void_update_poll(struct corsair_void_drvdata *drvdata)
+{
+	struct corsair_void_battery_data *battery_data;
+	unsigned int min_ms = READ_ONCE(poll_min_ms);
+	unsigned int max_ms = READ_ONCE(poll_max_ms);
+	struct corsair_void_state state;
+	unsigned int interval_ms;
+
+	corsair_void_get_state(drvdata, &state);
+	battery_data = &state.battery_data;
+
+	/* Wired headsets have no battery to poll */
+	if (drvdata->is_wired || !state.connected || max_ms == 0) {
+		WRITE_ONCE(drvdata->poll_interval_ms, 0);
+		return;
+	}
+
+	min_ms = min(min_ms, max_ms);
+	if (battery_data->status == POWER_SUPPLY_STATUS_CHARGING ||
+	    battery_data->capacity_level == POWER_SUPPLY_CAPACITY_LEVEL_LOW ||
+	    battery_data->capacity_level == POWER_SUPPLY_CAPACITY_LEVEL_CRITICAL)
+		interval_ms = min_ms;
+	else
+		interval_ms = clamp(READ_ONCE(drvdata->poll_interval_ms) * 2,
+				    min_ms, max_ms);
+
+	WRITE_ONCE(drvdata->poll_interval_ms, interval_ms);
+}
+
+/* A status reply arrived, so cancel any retry and wait for the next poll */
+static void corsair_void_status_replied(struct corsair_void_drvdata *drvdata,
+					bool connected)
+{
+	unsigned int interval_ms = READ_ONCE(drvdata->poll_interval_ms);
+
+	/* Usually already reset, so don't dirty its cacheline for every reply */
+	if (READ_ONCE(drvdata->status_retries) != CORSAIR_VOID_REQUEST_RETRIES)
+		WRITE_ONCE(drvdata->status_retries, CORSAIR_VOID_REQUEST_RETRIES);
+	if (drvdata->is_wired || !connected || !interval_ms ||
+	    !READ_ONCE(poll_max_ms)) {
+		cancel_delayed_work(&drvdata->delayed_status_work);
+		return;
+	}
+
+	mod_delayed_work(corsair_void_wq, &drvdata->delayed_status_work,
+			 msecs_to_jiffies(interval_ms));
+}
+
+/*
+ * Track the result of an automatic request
+ *   Returns the delay before trying again after a failure, or 0 on success
+ */
+static unsigned int corsair_void_update_backoff(struct corsair_void_backoff *backoff,
+						int ret)
+{
+	unsigned int failures, delay_ms;
+
+	if (ret >= 0) {
+		WRITE_ONCE(backoff->failures, 0);
+		WRITE_ONCE(backoff->delay_ms, 0);
+		return 0;
+	}
+
+	failures = backoff->failures + 1;
+	delay_ms = CORSAIR_VOID_REPLY_TIMEOUT_MS << min(failures - 1, 12U);
+	delay_ms = min(delay_ms, CORSAIR_VOID_BACKOFF_MAX_MS);
+
+	WRITE_ONCE(backoff->failures, failures);
+	WRITE_ONCE(backoff->delay_ms, delay_ms);
+	return delay_ms;
+}
+
 static void corsair_void_status_work_handler(struct work_struct *work)
 {
 	struct corsair_void_drvdata *drvdata;
 	struct delayed_work *delayed_work;
+	unsigned int retries, delay_ms;
 	int battery_ret;
 
 	delayed_work = container_of(work, struct delayed_work, work);
 	drvdata = container_of(delayed_work, struct corsair_void_drvdata,
 			       delayed_status_work);
 
+	/* Only back off for a new poll, not for a retry of an unanswered one */
+	retries = READ_ONCE(drvdata->status_retries);
+	if (retries == CORSAIR_VOID_REQUEST_RETRIES)
+		corsair_void_update_poll(drvdata);
+
 	battery_ret = corsair_void_request_status(drvdata->hid_dev,
 						  CORSAIR_VOID_STATUS_REPORT_ID);
-	if (battery_ret < 0) {
-		hid_warn(drvdata->hid_dev,
-			 "failed to request battery (reason: %d)", battery_ret);
+
+	/* Keep trying a broken device, just less and less often */
+	delay_ms = corsair_void_update_backoff(&drvdata->status_backoff,
+					       battery_ret);
+	if (delay_ms) {
+		hid_warn_ratelimited(drvdata->hid_dev,
+				     "failed to request battery (reason: %d)",
+				     battery_ret);
+		queue_delayed_work(corsair_void_wq, &drvdata->delayed_status_work,
+				   msecs_to_jiffies(delay_ms));
+		return;
+	}
+
+	/* A reply will replace this with the poll interval */
+	if (retries) {
+		WRITE_ONCE(drvdata->status_retries, retries - 1);
+		delay_ms = CORSAIR_VOID_REPLY_TIMEOUT_MS;
+	} else {
+		WRITE_ONCE(drvdata->status_retries, CORSAIR_VOID_REQUEST_RETRIES);
+		delay_ms = READ_ONCE(drvdata->poll_interval_ms);
+		if (!delay_ms)
+			return;
 	}
+
+	queue_delayed_work(corsair_void_wq, &drvdata->delayed_status_work,
+			   msecs_to_jiffies(delay_ms));
 }
 
 static void corsair_void_firmware_work_handler(struct work_struct *work)
 {
 	struct corsair_void_drvdata *drvdata;
 	struct delayed_work *delayed_work;
+	unsigned int retries, delay_ms;
 	int firmware_ret;
 
 	delayed_work = container_of(work, struct delayed_work, work);
@@ -529,11 +1557,56 @@ static void corsair_void_firmware_work_handler(struct work_struct *work)
 
 	firmware_ret = corsair_void_request_status(drvdata->hid_dev,
 						   CORSAIR_VOID_FIRMWARE_REPORT_ID);
-	if (firmware_ret < 0) {
-		hid_warn(drvdata->hid_dev,
-			 "failed to request firmware (reason: %d)", firmware_ret);
+
+	delay_ms = corsair_void_update_backoff(&drvdata->firmware_backoff,
+					       firmware_ret);
+	if (delay_ms) {
+		hid_warn_ratelimited(drvdata->hid_dev,
+				     "failed to request firmware (reason: %d)",
+				     firmware_ret);
+	} else {
+		delay_ms = CORSAIR_VOID_REPLY_TIMEOUT_MS;
+	}
+
+	/* A reply will cancel the retry, failures still use one up */
+	retries = READ_ONCE(drvdata->firmware_retries);
+	if (retries) {
+		WRITE_ONCE(drvdata->firmware_retries, retries - 1);
+		queue_delayed_work(corsair_void_wq, &drvdata->delayed_firmware_work,
+				   msecs_to_jiffies(delay_ms));
 	}
+}
+
+static void corsair_void_sidetone_work_handler(struct work_struct *work)
+{
+	struct corsair_void_drvdata *drvdata;
+	int sidetone, sidetone_ret;
+
+	drvdata = container_of(work, struct corsair_void_drvdata,
+			       sidetone_work);
+
+	sidetone = READ_ONCE(drvdata->sidetone_target);
+	if (sidetone < 0)
+		return;
+
+	sidetone_ret = corsair_void_apply_sidetone(drvdata, sidetone);
+	if (sidetone_ret < 0) {
+		hid_warn_ratelimited(drvdata->hid_dev,
+				     "failed to send sidetone (reason: %d)",
+				     sidetone_ret);
+	}
+}
 
+/* Whether the battery should currently be registered */
+static bool corsair_void_battery_wanted(struct corsair_void_drvdata *drvdata)
+{
+	struct corsair_void_state state;
+
+	if (drvdata->persistent_battery)
+		return true;
+
+	corsair_void_get_state(drvdata, &state);
+	return state.connected;
 }
 
 static void corsair_void_battery_remove_work_handler(struct work_struct *work)
@@ -542,11 +1615,18 @@ static void corsair_void_battery_remove_work_handler(struct work_struct *work)
 
 	drvdata = container_of(work, struct corsair_void_drvdata,
 			       battery_remove_work);
-	scoped_guard(mutex, &drvdata->battery_mutex) {
-		if (drvdata->battery) {
-			power_supply_unregister(drvdata->battery);
-			drvdata->battery = NULL;
-		}
+
+	/*
+	 * Add and remove may run out of order, so follow the current state
+	 *   Checked under the mutex, so the other handler can't act in between
+	 */
+	guard(mutex)(&drvdata->battery_mutex);
+	if (corsair_void_battery_wanted(drvdata))
+		return;
+
+	if (drvdata->battery) {
+		power_supply_unregister(drvdata->battery);
+		drvdata->battery = NULL;
 	}
 }
 
@@ -558,8 +1638,9 @@ static void corsair_void_battery_add_work_handler(struct work_struct *work)
 
 	drvdata = container_of(work, struct corsair_void_drvdata,
 			       battery_add_work);
+
 	guard(mutex)(&drvdata->battery_mutex);
-	if (drvdata->battery)
+	if (!corsair_void_battery_wanted(drvdata) || drvdata->battery)
 		return;
 
 	psy_cfg.drv_data = drvdata;
@@ -583,45 +1664,593 @@ static void corsair_void_battery_add_work_handler(struct work_struct *work)
 	drvdata->battery = new_supply;
 }
 
+static void corsair_void_battery_changed_work_handler(struct work_struct *work)
+{
+	struct corsair_void_drvdata *drvdata;
+
+	drvdata = container_of(to_delayed_work(work),
+			       struct corsair_void_drvdata,
+			       battery_changed_work);
+
+	/* Any reports after this point will queue another notification */
+	if (!test_and_clear_bit(CORSAIR_VOID_BATTERY_CHANGED, &drvdata->flags))
+		return;
+
+	WRITE_ONCE(drvdata->notified_jiffies, jiffies);
+
+	scoped_guard(mutex, &drvdata->battery_mutex) {
+		if (drvdata->battery) {
+			corsair_void_stat_inc(drvdata, battery_notifications);
+			power_supply_changed(drvdata->battery);
+		}
+	}
+}
+
+/* Keep the receiver awake while a headset is connected, let it idle otherwise */
+static void corsair_void_pm_work_handler(struct work_struct *work)
+{
+	struct corsair_void_drvdata *drvdata;
+	struct corsair_void_state state;
+
+	drvdata = container_of(work, struct corsair_void_drvdata, pm_work);
+	corsair_void_get_state(drvdata, &state);
+
+	if (state.connected == drvdata->pm_awake)
+		return;
+
+	if (state.connected) {
+		if (corsair_void_power_get(drvdata) < 0)
+			return;
+	} else {
+		corsair_void_power_put(drvdata);
+	}
+
+	drvdata->pm_awake = state.connected;
+}
+
 static void corsair_void_headset_connected(struct corsair_void_drvdata *drvdata)
 {
-	schedule_work(&drvdata->battery_add_work);
-	schedule_delayed_work(&drvdata->delayed_firmware_work,
-			      msecs_to_jiffies(100));
+	corsair_void_stat_inc(drvdata, connects);
+	queue_work(corsair_void_wq, &drvdata->pm_work);
+	if (!drvdata->persistent_battery)
+		queue_work(corsair_void_wq, &drvdata->battery_add_work);
+
+	/* Replay the last requested sidetone to the new headset */
+	if (READ_ONCE(drvdata->sidetone_target) >= 0)
+		queue_work(corsair_void_wq, &drvdata->sidetone_work);
+
+	/* Ask for the new headset's firmware straight away, unless it's lazy */
+	if (!drvdata->lazy_firmware) {
+		WRITE_ONCE(drvdata->firmware_retries, CORSAIR_VOID_REQUEST_RETRIES);
+		mod_delayed_work(corsair_void_wq, &drvdata->delayed_firmware_work, 0);
+	}
+
+	/* Start polling the new headset's battery quickly */
+	drvdata->battery_wait_ns = ktime_get_ns();
+	WRITE_ONCE(drvdata->status_retries, CORSAIR_VOID_REQUEST_RETRIES);
+	WRITE_ONCE(drvdata->poll_interval_ms, READ_ONCE(poll_min_ms));
+	if (READ_ONCE(poll_max_ms)) {
+		queue_delayed_work(corsair_void_wq, &drvdata->delayed_status_work,
+				   msecs_to_jiffies(READ_ONCE(poll_min_ms)));
+	}
 }
 
 static void corsair_void_headset_disconnected(struct corsair_void_drvdata *drvdata)
 {
-	schedule_work(&drvdata->battery_remove_work);
+	corsair_void_stat_inc(drvdata, disconnects);
+
+	/* The next headset may report the same firmware, it must still be seen */
+	drvdata->last_firmware[0] = 0;
+	queue_work(corsair_void_wq, &drvdata->pm_work);
+	if (!drvdata->persistent_battery)
+		queue_work(corsair_void_wq, &drvdata->battery_remove_work);
+	cancel_delayed_work(&drvdata->delayed_status_work);
+	WRITE_ONCE(drvdata->sidetone_stale, true);
 
 	corsair_void_set_unknown_wireless_data(drvdata);
 	corsair_void_set_unknown_batt(drvdata);
 }
 
+/*
+ * Debugfs statistics
+*/
+
+static struct dentry *corsair_void_debugfs_root;
+
+/* Every bound device, for the driver-wide view */
+static LIST_HEAD(corsair_void_devices_list);
+static DEFINE_MUTEX(corsair_void_devices_mutex);
+
+static void corsair_void_record_latency(struct corsair_void_drvdata *drvdata,
+					s64 latency_ns)
+{
+	u64 latency_us = div_u64(latency_ns, NSEC_PER_USEC);
+	unsigned int bucket = 0;
+
+	if (latency_us)
+		bucket = min(ilog2(latency_us) + 1,
+			     CORSAIR_VOID_LATENCY_BUCKETS - 1);
+
+	corsair_void_stat_inc(drvdata, status_latency[bucket]);
+}
+
+static void corsair_void_read_stats(struct corsair_void_drvdata *drvdata,
+				    struct corsair_void_stats *total)
+{
+	unsigned long *sum = (unsigned long *)total;
+	const unsigned long *counts;
+	unsigned int i;
+	int cpu;
+
+	memset(total, 0, sizeof(*total));
+	for_each_possible_cpu(cpu) {
+		counts = (const unsigned long *)per_cpu_ptr(drvdata->stats, cpu);
+		for (i = 0; i < sizeof(*total) / sizeof(*sum); i++)
+			sum[i] += READ_ONCE(counts[i]);
+	}
+}
+
+static int corsair_void_stats_show(struct seq_file *m, void *unused)
+{
+	struct corsair_void_drvdata *drvdata = m->private;
+	struct corsair_void_stats stats;
+
+	corsair_void_read_stats(drvdata, &stats);
+
+	seq_printf(m, "status_reports: %lu\n", stats.status_reports);
+	seq_printf(m, "firmware_reports: %lu\n", stats.firmware_reports);
+	seq_printf(m, "other_reports: %lu\n", stats.other_reports);
+	seq_printf(m, "unknown_battery_status: %lu\n", stats.unknown_battery_status);
+	seq_printf(m, "request_failures: %lu\n", stats.request_failures);
+	seq_printf(m, "connects: %lu\n", stats.connects);
+	seq_printf(m, "disconnects: %lu\n", stats.disconnects);
+	seq_printf(m, "battery_notifications: %lu\n", stats.battery_notifications);
+	seq_printf(m, "duplicate_reports: %lu\n", stats.duplicate_reports);
+	seq_printf(m, "capture_dropped: %ld\n",
+		   atomic_long_read(&drvdata->capture.dropped));
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(corsair_void_stats);
+
+static int corsair_void_latency_show(struct seq_file *m, void *unused)
+{
+	struct corsair_void_drvdata *drvdata = m->private;
+	struct corsair_void_stats stats;
+	unsigned long *buckets = stats.status_latency;
+	int i;
+
+	corsair_void_read_stats(drvdata, &stats);
+
+	seq_printf(m, "<1us: %lu\n", buckets[0]);
+	for (i = 1; i < CORSAIR_VOID_LATENCY_BUCKETS - 1; i++)
+		seq_printf(m, "%luus-%luus: %lu\n", BIT(i - 1), BIT(i), buckets[i]);
+	seq_printf(m, ">=%luus: %lu\n", BIT(i - 1), buckets[i]);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(corsair_void_latency);
+
+static int corsair_void_backoff_show(struct seq_file *m, void *unused)
+{
+	struct corsair_void_drvdata *drvdata = m->private;
+
+	seq_printf(m, "status_failures: %u\n",
+		   READ_ONCE(drvdata->status_backoff.failures));
+	seq_printf(m, "status_backoff_ms: %u\n",
+		   READ_ONCE(drvdata->status_backoff.delay_ms));
+	seq_printf(m, "firmware_failures: %u\n",
+		   READ_ONCE(drvdata->firmware_backoff.failures));
+	seq_printf(m, "firmware_backoff_ms: %u\n",
+		   READ_ONCE(drvdata->firmware_backoff.delay_ms));
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(corsair_void_backoff);
+
+/* One line per device, using the same keys as the status attribute */
+static int corsair_void_devices_show(struct seq_file *m, void *unused)
+{
+	struct corsair_void_battery_data *battery_data;
+	struct corsair_void_drvdata *drvdata;
+	struct corsair_void_state state;
+
+	guard(mutex)(&corsair_void_devices_mutex);
+	list_for_each_entry(drvdata, &corsair_void_devices_list, node) {
+		corsair_void_get_state(drvdata, &state);
+		battery_data = &state.battery_data;
+
+		seq_printf(m, "%s connected=%d microphone_up=%d",
+			   dev_name(drvdata->dev), state.connected,
+			   state.mic_up);
+		seq_printf(m, " battery_present=%d battery_status=%d",
+			   battery_data->present, battery_data->status);
+		seq_printf(m, " battery_capacity=%d battery_capacity_level=%d",
+			   battery_data->capacity,
+			   battery_data->capacity_level);
+		seq_printf(m, " fw_version_receiver=%d.%02d fw_version_headset=%d.%02d",
+			   state.fw_receiver_major, state.fw_receiver_minor,
+			   state.fw_headset_major, state.fw_headset_minor);
+		seq_printf(m, " sidetone=%d\n", READ_ONCE(drvdata->sidetone));
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(corsair_void_devices);
+
+static void corsair_void_process_report(struct corsair_void_drvdata *drvdata,
+					u8 *data, int size);
+
+/* Push a report into the capture ring, never blocking the report path */
+static void corsair_void_capture_report(struct corsair_void_drvdata *drvdata,
+					const u8 *data, int size)
+{
+	struct corsair_void_capture *capture = &drvdata->capture;
+	struct corsair_void_capture_record *record;
+	unsigned long head, tail;
+
+	if (!capture->records)
+		return;
+
+	head = capture->head;
+	tail = READ_ONCE(capture->tail);
+	if (CIRC_SPACE(head, tail, CORSAIR_VOID_CAPTURE_RECORDS) < 1) {
+		atomic_long_inc(&capture->dropped);
+		return;
+	}
+
+	record = &capture->records[head];
+	record->timestamp_ns = cpu_to_le64(ktime_get_ns());
+	record->size = min(size, CORSAIR_VOID_CAPTURE_DATA_SIZE);
+	memcpy(record->data, data, record->size);
+
+	/* Publish the record before the reader can see the new head */
+	smp_store_release(&capture->head,
+			  (head + 1) & (CORSAIR_VOID_CAPTURE_RECORDS - 1));
+}
+
+/* Drain whole records from the capture ring */
+static ssize_t corsair_void_capture_read(struct file *file, char __user *buf,
+					 size_t count, loff_t *ppos)
+{
+	struct corsair_void_drvdata *drvdata = file->private_data;
+	struct corsair_void_capture *capture = &drvdata->capture;
+	const size_t record_size = sizeof(struct corsair_void_capture_record);
+	unsigned long head, tail;
+	size_t copied = 0;
+
+	if (count < record_size)
+		return -EINVAL;
+
+	guard(mutex)(&capture->read_mutex);
+	head = smp_load_acquire(&capture->head);
+	tail = capture->tail;
+
+	while (CIRC_CNT(head, tail, CORSAIR_VOID_CAPTURE_RECORDS) >= 1 &&
+	       count - copied >= record_size) {
+		if (copy_to_user(buf + copied, &capture->records[tail],
+				 record_size))
+			break;
+
+		copied += record_size;
+		tail = (tail + 1) & (CORSAIR_VOID_CAPTURE_RECORDS - 1);
+	}
+
+	/* Finish reading the records before the producer can reuse them */
+	smp_store_release(&capture->tail, tail);
+
+	if (!copied && CIRC_CNT(head, tail, CORSAIR_VOID_CAPTURE_RECORDS))
+		return -EFAULT;
+
+	return copied;
+}
+
+static const struct file_operations corsair_void_capture_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.read = corsair_void_capture_read,
+};
+
+/* Replay captured records through the report parser, ignoring timestamps */
+static ssize_t corsair_void_inject_write(struct file *file,
+					 const char __user *buf,
+					 size_t count, loff_t *ppos)
+{
+	struct corsair_void_drvdata *drvdata = file->private_data;
+	struct corsair_void_capture_record record;
+	size_t offset;
+
+	if (count % sizeof(record))
+		return -EINVAL;
+
+	for (offset = 0; offset < count; offset += sizeof(record)) {
+		if (copy_from_user(&record, buf + offset, sizeof(record)))
+			return -EFAULT;
+
+		if (record.size > CORSAIR_VOID_CAPTURE_DATA_SIZE)
+			return -EINVAL;
+
+		corsair_void_process_report(drvdata, record.data, record.size);
+	}
+
+	return count;
+}
+
+static const struct file_operations corsair_void_inject_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.write = corsair_void_inject_write,
+};
+
+static int corsair_void_capture_init(struct corsair_void_drvdata *drvdata)
+{
+	struct corsair_void_capture *capture = &drvdata->capture;
+
+	if (!capture_reports)
+		return 0;
+
+	capture->records = devm_kcalloc(drvdata->dev,
+					CORSAIR_VOID_CAPTURE_RECORDS,
+					sizeof(*capture->records), GFP_KERNEL);
+	if (!capture->records)
+		return -ENOMEM;
+
+	return devm_mutex_init(drvdata->dev, &capture->read_mutex);
+}
+
+static void corsair_void_debugfs_init(struct corsair_void_drvdata *drvdata)
+{
+	drvdata->debugfs = debugfs_create_dir(dev_name(drvdata->dev),
+					      corsair_void_debugfs_root);
+
+	debugfs_create_file("stats", 0444, drvdata->debugfs, drvdata,
+			    &corsair_void_stats_fops);
+	debugfs_create_file("status_latency", 0444, drvdata->debugfs, drvdata,
+			    &corsair_void_latency_fops);
+	debugfs_create_file("backoff", 0444, drvdata->debugfs, drvdata,
+			    &corsair_void_backoff_fops);
+	debugfs_create_file("inject", 0200, drvdata->debugfs, drvdata,
+			    &corsair_void_inject_fops);
+
+	if (drvdata->capture.records) {
+		debugfs_create_file("capture", 0400, drvdata->debugfs, drvdata,
+				    &corsair_void_capture_fops);
+	}
+}
+
+/*
+ * Event device, shared by every bound device
+ *   Any report path can produce, so producers serialise on a spinlock
+ *   Only one reader may open the device, so it consumes without the lock
+*/
+
+static DEFINE_KFIFO(corsair_void_events, struct corsair_void_event,
+		    CORSAIR_VOID_EVENT_RECORDS);
+static DEFINE_SPINLOCK(corsair_void_events_lock);
+static DECLARE_WAIT_QUEUE_HEAD(corsair_void_events_wait);
+static DEFINE_MUTEX(corsair_void_events_read_mutex);
+static atomic_long_t corsair_void_events_dropped;
+static unsigned long corsair_void_events_open;
+
+static void corsair_void_queue_event(struct corsair_void_drvdata *drvdata,
+				     const struct corsair_void_state *state,
+				     u8 type, u64 timestamp_ns)
+{
+	const struct corsair_void_battery_data *battery_data = &state->battery_data;
+	struct corsair_void_event event = {
+		.timestamp_ns = cpu_to_le64(timestamp_ns),
+		.hid_id = cpu_to_le32(drvdata->hid_dev->id),
+		.type = type,
+		.connected = state->connected,
+		.mic_up = state->mic_up,
+		.power_button = state->power_button,
+		.battery_present = battery_data->present,
+		.battery_status = battery_data->status,
+		.battery_capacity = battery_data->capacity,
+	};
+
+	/* Drop new events rather than old ones, so readers never see a gap */
+	if (!kfifo_in_spinlocked(&corsair_void_events, &event, 1,
+				 &corsair_void_events_lock))
+		atomic_long_inc(&corsair_void_events_dropped);
+}
+
+/* Queue a record for each kind of change between two states */
+static void corsair_void_queue_events(struct corsair_void_drvdata *drvdata,
+				      const struct corsair_void_state *old,
+				      const struct corsair_void_state *new)
+{
+	const struct corsair_void_battery_data *old_battery = &old->battery_data;
+	const struct corsair_void_battery_data *new_battery = &new->battery_data;
+	u64 timestamp_ns = ktime_get_ns();
+	bool queued = false;
+
+	if (old->connected != new->connected) {
+		corsair_void_queue_event(drvdata, new, new->connected ?
+					 CORSAIR_VOID_EVENT_CONNECT :
+					 CORSAIR_VOID_EVENT_DISCONNECT,
+					 timestamp_ns);
+		queued = true;
+	}
+
+	if (old_battery->present != new_battery->present ||
+	    old_battery->status != new_battery->status ||
+	    old_battery->capacity != new_battery->capacity) {
+		corsair_void_queue_event(drvdata, new, CORSAIR_VOID_EVENT_BATTERY,
+					 timestamp_ns);
+		queued = true;
+	}
+
+	if (old->mic_up != new->mic_up) {
+		corsair_void_queue_event(drvdata, new, CORSAIR_VOID_EVENT_MIC,
+					 timestamp_ns);
+		queued = true;
+	}
+
+	if (old->power_button != new->power_button) {
+		corsair_void_queue_event(drvdata, new,
+					 CORSAIR_VOID_EVENT_POWER_BUTTON,
+					 timestamp_ns);
+		queued = true;
+	}
+
+	if (queued)
+		wake_up_interruptible(&corsair_void_events_wait);
+}
+
+static int corsair_void_events_open_file(struct inode *inode, struct file *file)
+{
+	if (test_and_set_bit(0, &corsair_void_events_open))
+		return -EBUSY;
+
+	return nonseekable_open(inode, file);
+}
+
+static int corsair_void_events_release(struct inode *inode, struct file *file)
+{
+	clear_bit(0, &corsair_void_events_open);
+	return 0;
+}
+
+/* Copies as many whole records as fit, blocking until at least one is queued */
+static ssize_t corsair_void_events_read(struct file *file, char __user *buf,
+					size_t count, loff_t *ppos)
+{
+	const size_t record_size = sizeof(struct corsair_void_event);
+	unsigned int copied;
+	int ret;
+
+	if (count < record_size)
+		return -EINVAL;
+
+	guard(mutex)(&corsair_void_events_read_mutex);
+	while (kfifo_is_empty(&corsair_void_events)) {
+		if (file->f_flags & O_NONBLOCK)
+			return -EAGAIN;
+
+		ret = wait_event_interruptible(corsair_void_events_wait,
+					       !kfifo_is_empty(&corsair_void_events));
+		if (ret)
+			return ret;
+	}
+
+	ret = kfifo_to_user(&corsair_void_events, buf,
+			    rounddown(count, record_size), &copied);
+	if (ret)
+		return ret;
+
+	return copied;
+}
+
+static __poll_t corsair_void_events_poll(struct file *file, poll_table *wait)
+{
+	poll_wait(file, &corsair_void_events_wait, wait);
+
+	if (!kfifo_is_empty(&corsair_void_events))
+		return EPOLLIN | EPOLLRDNORM;
+
+	return 0;
+}
+
+static const struct file_operations corsair_void_events_fops = {
+	.owner = THIS_MODULE,
+	.open = corsair_void_events_open_file,
+	.release = corsair_void_events_release,
+	.read = corsair_void_events_read,
+	.poll = corsair_void_events_poll,
+};
+
+static int corsair_void_events_stats_show(struct seq_file *m, void *unused)
+{
+	seq_printf(m, "queued: %u\n", kfifo_len(&corsair_void_events));
+	seq_printf(m, "dropped: %ld\n",
+		   atomic_long_read(&corsair_void_events_dropped));
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(corsair_void_events_stats);
+
+static struct miscdevice corsair_void_events_miscdev = {
+	.minor = MISC_DYNAMIC_MINOR,
+	.name = "corsair_void",
+	.fops = &corsair_void_events_fops,
+};
+
 /*
  * Driver setup, probing and HID event handling
 */
 
+static void corsair_void_kfree(void *data)
+{
+	kfree(data);
+}
+
+static int corsair_void_input_init(struct corsair_void_drvdata *drvdata)
+{
+	struct hid_device *hid_dev = drvdata->hid_dev;
+	struct input_dev *input_dev;
+
+	input_dev = devm_input_allocate_device(drvdata->dev);
+	if (!input_dev)
+		return -ENOMEM;
+
+	input_dev->name = devm_kasprintf(drvdata->dev, GFP_KERNEL,
+					 "%s Controls", hid_dev->name);
+	if (!input_dev->name)
+		return -ENOMEM;
+
+	input_dev->phys = hid_dev->phys;
+	input_dev->uniq = hid_dev->uniq;
+	input_dev->id.bustype = hid_dev->bus;
+	input_dev->id.vendor = hid_dev->vendor;
+	input_dev->id.product = hid_dev->product;
+	input_dev->id.version = hid_dev->version;
+
+	input_set_capability(input_dev, EV_KEY, CORSAIR_VOID_POWER_BUTTON_KEY);
+	input_set_capability(input_dev, EV_SW, CORSAIR_VOID_MIC_UP_SWITCH);
+
+	drvdata->input_dev = input_dev;
+	return input_register_device(input_dev);
+}
+
+static DEVICE_ATTR_RO(connected);
 static DEVICE_ATTR_RO(fw_version_receiver);
 static DEVICE_ATTR_RO(fw_version_headset);
 static DEVICE_ATTR_RO(microphone_up);
 static DEVICE_ATTR_RO(sidetone_max);
+static DEVICE_ATTR_RO(sidetone);
+static DEVICE_ATTR_RO(status);
 
+static DEVICE_ATTR_WO(refresh);
 static DEVICE_ATTR_WO(send_alert);
 static DEVICE_ATTR_WO(set_sidetone);
 
 static struct attribute *corsair_void_attrs[] = {
+	&dev_attr_connected.attr,
 	&dev_attr_fw_version_receiver.attr,
 	&dev_attr_fw_version_headset.attr,
 	&dev_attr_microphone_up.attr,
+	&dev_attr_refresh.attr,
 	&dev_attr_send_alert.attr,
 	&dev_attr_set_sidetone.attr,
 	&dev_attr_sidetone_max.attr,
+	&dev_attr_sidetone.attr,
+	&dev_attr_status.attr,
+	NULL,
+};
+
+static CORSAIR_VOID_BIN_ATTR_CONST BIN_ATTR_RO(status_bin,
+					       sizeof(struct corsair_void_status_bin));
+
+static CORSAIR_VOID_BIN_ATTR_CONST struct bin_attribute
+	*CORSAIR_VOID_BIN_ATTR_CONST corsair_void_bin_attrs[] = {
+	&bin_attr_status_bin,
 	NULL,
 };
 
 static const struct attribute_group corsair_void_attr_group = {
 	.attrs = corsair_void_attrs,
+	.bin_attrs = corsair_void_bin_attrs,
 };
 
 static int corsair_void_probe(struct hid_device *hid_dev,
@@ -629,36 +2258,62 @@ static int corsair_void_probe(struct hid_device *hid_dev,
 {
 	int ret;
 	struct corsair_void_drvdata *drvdata;
+	struct usb_interface *usb_if;
+	struct usb_device *usb_dev;
 	char *name;
 
-	if (!hid_is_usb(hid_dev))
+	/* Emulated receivers have no USB device behind them, so never wired ones */
+	if (!hid_is_usb(hid_dev) &&
+	    (!allow_emulated ||
+	     ((const struct corsair_void_model *)hid_id->driver_data)->is_wired))
 		return -EINVAL;
 
-	drvdata = devm_kzalloc(&hid_dev->dev, sizeof(*drvdata),
-			       GFP_KERNEL);
+	/* Not devm_kzalloc(), so the hot report state stays cacheline aligned */
+	drvdata = kzalloc(sizeof(*drvdata), GFP_KERNEL);
 	if (!drvdata)
 		return -ENOMEM;
 
+	ret = devm_add_action_or_reset(&hid_dev->dev, corsair_void_kfree,
+				       drvdata);
+	if (ret)
+		return ret;
+
+	drvdata->stats = devm_alloc_percpu(&hid_dev->dev,
+					   struct corsair_void_stats);
+	if (!drvdata->stats)
+		return -ENOMEM;
+
 	hid_set_drvdata(hid_dev, drvdata);
 	dev_set_drvdata(&hid_dev->dev, drvdata);
 
 	drvdata->dev = &hid_dev->dev;
 	drvdata->hid_dev = hid_dev;
-	drvdata->is_wired = hid_id->driver_data == CORSAIR_VOID_WIRED;
+	drvdata->model = (const struct corsair_void_model *)hid_id->driver_data;
+	drvdata->is_wired = drvdata->model->is_wired;
+	drvdata->is_usb = hid_is_usb(hid_dev);
+	drvdata->persistent_battery = persistent_battery && !drvdata->is_wired;
+	drvdata->lazy_firmware = lazy_firmware;
 
-	drvdata->sidetone_max = CORSAIR_VOID_SIDETONE_MAX_WIRELESS;
-	if (drvdata->is_wired)
-		drvdata->sidetone_max = CORSAIR_VOID_SIDETONE_MAX_WIRED;
+	/* Sidetone is unknown until userspace sets it */
+	drvdata->sidetone = -1;
+	drvdata->sidetone_target = -1;
+
+	seqlock_init(&drvdata->state_lock);
+	spin_lock_init(&drvdata->report_lock);
 
 	/* Set initial values for no wireless headset attached */
 	/* If a headset is attached, it'll be prompted later */
 	corsair_void_set_unknown_wireless_data(drvdata);
 	corsair_void_set_unknown_batt(drvdata);
+	/* The zeroed history is already reset, but no estimate is known yet */
+	drvdata->history.status = POWER_SUPPLY_STATUS_UNKNOWN;
+	drvdata->state.time_to_empty = -1;
+	drvdata->notified_battery = drvdata->state.battery_data;
 
 	/* Receiver version won't be reset after init */
 	/* Headset version already set via set_unknown_wireless_data */
-	drvdata->fw_receiver_major = 0;
-	drvdata->fw_receiver_minor = 0;
+	drvdata->state.fw_receiver_major = 0;
+	drvdata->state.fw_receiver_minor = 0;
 
 	ret = hid_parse(hid_dev);
 	if (ret) {
@@ -682,36 +2337,137 @@ static int corsair_void_probe(struct hid_device *hid_dev,
 		  corsair_void_battery_remove_work_handler);
 	INIT_WORK(&drvdata->battery_add_work,
 		  corsair_void_battery_add_work_handler);
+	INIT_DELAYED_WORK(&drvdata->battery_changed_work,
+			  corsair_void_battery_changed_work_handler);
+	INIT_WORK(&drvdata->sidetone_work, corsair_void_sidetone_work_handler);
+	INIT_WORK(&drvdata->pm_work, corsair_void_pm_work_handler);
+	INIT_DELAYED_WORK(&drvdata->delayed_status_work,
+			  corsair_void_status_work_handler);
+	INIT_DELAYED_WORK(&drvdata->delayed_firmware_work,
+			  corsair_void_firmware_work_handler);
+	ret = devm_mutex_init(drvdata->dev, &drvdata->sidetone_mutex);
+	if (ret)
+		return ret;
 	ret = devm_mutex_init(drvdata->dev, &drvdata->battery_mutex);
 	if (ret)
 		return ret;
 
+	/* Power of 2 kmalloc() sizes are naturally aligned, and DMA-safe */
+	drvdata->request_buf = kzalloc(CORSAIR_VOID_REQUEST_BUF_SIZE,
+				       GFP_KERNEL);
+	if (!drvdata->request_buf)
+		return -ENOMEM;
+
+	ret = devm_add_action_or_reset(drvdata->dev,
+				       corsair_void_kfree,
+				       drvdata->request_buf);
+	if (ret)
+		return ret;
+
+	ret = devm_mutex_init(drvdata->dev, &drvdata->request_mutex);
+	if (ret)
+		return ret;
+
+	ret = devm_mutex_init(drvdata->dev, &drvdata->firmware_mutex);
+	if (ret)
+		return ret;
+	init_completion(&drvdata->firmware_done);
+
+	ret = devm_mutex_init(drvdata->dev, &drvdata->refresh_mutex);
+	if (ret)
+		return ret;
+	init_waitqueue_head(&drvdata->refresh_wait);
+
+	ret = corsair_void_capture_init(drvdata);
+	if (ret)
+		return ret;
+
+	ret = corsair_void_input_init(drvdata);
+	if (ret) {
+		hid_err(hid_dev, "failed to register input device (reason: %d)\n",
+			ret);
+		return ret;
+	}
+
 	ret = sysfs_create_group(&hid_dev->dev.kobj, &corsair_void_attr_group);
 	if (ret)
 		return ret;
 
+	/* Cache nodes for attributes that notify pollers from raw_event */
+	drvdata->mic_up_kn = sysfs_get_dirent(hid_dev->dev.kobj.sd,
+					      "microphone_up");
+	drvdata->connected_kn = sysfs_get_dirent(hid_dev->dev.kobj.sd,
+						 "connected");
+	if (!drvdata->mic_up_kn || !drvdata->connected_kn) {
+		ret = -ENODEV;
+		goto failed_after_dirents;
+	}
+
 	/* Any failures after here will need to call hid_hw_stop */
 	ret = hid_hw_start(hid_dev, HID_CONNECT_DEFAULT);
 	if (ret) {
 		hid_err(hid_dev, "hid_hw_start failed (reason: %d)\n", ret);
-		goto failed_after_sysfs;
+		goto failed_after_dirents;
 	}
 
-	/* Refresh battery data, in case wireless headset is already connected */
-	INIT_DELAYED_WORK(&drvdata->delayed_status_work,
-			  corsair_void_status_work_handler);
-	schedule_delayed_work(&drvdata->delayed_status_work,
-			      msecs_to_jiffies(100));
+	/*
+	 * Idle receivers may autosuspend, a connected headset holds them awake
+	 *   The delay and resume latency are tuned through the USB device's power/
+	 */
+	if (autosuspend && !drvdata->is_wired && drvdata->is_usb) {
+		usb_if = to_usb_interface(drvdata->dev->parent);
+		usb_dev = interface_to_usbdev(usb_if);
+
+		/* Leave a policy set before binding alone, e.g. by udev */
+		if (!corsair_void_autosuspend_allowed(usb_dev)) {
+			usb_enable_autosuspend(usb_dev);
+			drvdata->autosuspend_enabled = true;
+		}
+	}
 
-	/* Refresh firmware versions */
-	INIT_DELAYED_WORK(&drvdata->delayed_firmware_work,
-			  corsair_void_firmware_work_handler);
-	schedule_delayed_work(&drvdata->delayed_firmware_work,
-			      msecs_to_jiffies(100));
+	/* Register the battery once, connections only change its properties */
+	if (drvdata->persistent_battery)
+		queue_work(corsair_void_wq, &drvdata->battery_add_work);
+
+	/*
+	 * Refresh battery data and firmware versions, in case a wireless headset
+	 * is already connected
+	 *   Input is enabled first, so the replies aren't dropped
+	 *   Both requests are sent back to back, with a retry queued for each
+	 */
+	drvdata->status_retries = CORSAIR_VOID_REQUEST_RETRIES - 1;
+	drvdata->firmware_retries = CORSAIR_VOID_REQUEST_RETRIES - 1;
+	drvdata->battery_wait_ns = ktime_get_ns();
+	hid_device_io_start(hid_dev);
+
+	ret = corsair_void_request_status(hid_dev, CORSAIR_VOID_STATUS_REPORT_ID);
+	if (ret < 0)
+		hid_warn(hid_dev, "failed to request battery (reason: %d)", ret);
+	queue_delayed_work(corsair_void_wq, &drvdata->delayed_status_work,
+			   msecs_to_jiffies(CORSAIR_VOID_REPLY_TIMEOUT_MS));
+
+	if (!drvdata->lazy_firmware) {
+		ret = corsair_void_request_status(hid_dev,
+						  CORSAIR_VOID_FIRMWARE_REPORT_ID);
+		if (ret < 0) {
+			hid_warn(hid_dev, "failed to request firmware (reason: %d)",
+				 ret);
+		}
+
+		queue_delayed_work(corsair_void_wq, &drvdata->delayed_firmware_work,
+				   msecs_to_jiffies(CORSAIR_VOID_REPLY_TIMEOUT_MS));
+	}
+
+	corsair_void_debugfs_init(drvdata);
+
+	scoped_guard(mutex, &corsair_void_devices_mutex)
+		list_add_tail(&drvdata->node, &corsair_void_devices_list);
 
 	return 0;
 
-failed_after_sysfs:
+failed_after_dirents:
+	sysfs_put(drvdata->connected_kn);
+	sysfs_put(drvdata->mic_up_kn);
 	sysfs_remove_group(&hid_dev->dev.kobj, &corsair_void_attr_group);
 	return ret;
 }
@@ -719,50 +2475,377 @@ failed_after_sysfs:
 static void corsair_void_remove(struct hid_device *hid_dev)
 {
 	struct corsair_void_drvdata *drvdata = hid_get_drvdata(hid_dev);
+	struct usb_interface *usb_if;
+
+	scoped_guard(mutex, &corsair_void_devices_mutex)
+		list_del(&drvdata->node);
+
+	debugfs_remove_recursive(drvdata->debugfs);
+
+	/* Remove sysfs first, so writes can't queue sidetone work */
+	sysfs_remove_group(&hid_dev->dev.kobj, &corsair_void_attr_group);
 
 	hid_hw_stop(hid_dev);
+	sysfs_put(drvdata->connected_kn);
+	sysfs_put(drvdata->mic_up_kn);
+
+	/* No more reports can queue sidetone or pm work once stopped */
+	cancel_work_sync(&drvdata->sidetone_work);
+	cancel_work_sync(&drvdata->pm_work);
+	if (drvdata->pm_awake)
+		corsair_void_power_put(drvdata);
+
+	/* Hand the receiver back with the autosuspend policy it was found with */
+	if (drvdata->autosuspend_enabled) {
+		usb_if = to_usb_interface(drvdata->dev->parent);
+		usb_disable_autosuspend(interface_to_usbdev(usb_if));
+	}
+
 	cancel_work_sync(&drvdata->battery_remove_work);
 	cancel_work_sync(&drvdata->battery_add_work);
+	cancel_delayed_work_sync(&drvdata->battery_changed_work);
 	if (drvdata->battery)
 		power_supply_unregister(drvdata->battery);
 
+	cancel_delayed_work_sync(&drvdata->delayed_status_work);
 	cancel_delayed_work_sync(&drvdata->delayed_firmware_work);
-	sysfs_remove_group(&hid_dev->dev.kobj, &corsair_void_attr_group);
 }
 
-static int corsair_void_raw_event(struct hid_device *hid_dev,
-				  struct hid_report *hid_report,
-				  u8 *data, int size)
+/* Time since the matching request was sent, or 0 if there wasn't one */
+static s64 corsair_void_request_latency(atomic64_t *request_ns)
 {
-	struct corsair_void_drvdata *drvdata = hid_get_drvdata(hid_dev);
-	bool was_connected = drvdata->connected;
+	s64 sent_ns;
 
-	/* Description of packets are documented at the top of this file */
-	if (hid_report->id == CORSAIR_VOID_STATUS_REPORT_ID) {
-		drvdata->mic_up = FIELD_GET(CORSAIR_VOID_MIC_MASK, data[2]);
-		drvdata->connected = (data[3] == CORSAIR_VOID_WIRELESS_CONNECTED) ||
-				     drvdata->is_wired;
+	/* Unprompted reports only read the timestamp */
+	if (!atomic64_read(request_ns))
+		return 0;
+
+	sent_ns = atomic64_xchg(request_ns, 0);
+	if (!sent_ns)
+		return 0;
+
+	return ktime_get_ns() - sent_ns;
+}
+
+/*
+ * Check a report against the last accepted copy, recording it if it's new
+ *   Called with the report lock held, before anything is decoded
+ *   Runs after any HID-BPF programs, so it compares their output
+ */
+static bool corsair_void_is_duplicate(struct corsair_void_drvdata *drvdata,
+				      const u8 *data, u8 report_id)
+{
+	u8 *last;
+
+	if (report_id == CORSAIR_VOID_STATUS_REPORT_ID)
+		last = drvdata->last_status;
+	else if (report_id == CORSAIR_VOID_FIRMWARE_REPORT_ID)
+		last = drvdata->last_firmware;
+	else
+		return false;
+
+	if (READ_ONCE(filter_duplicates) &&
+	    !memcmp(last, data, CORSAIR_VOID_REPORT_SIZE))
+		return true;
+
+	memcpy(last, data, CORSAIR_VOID_REPORT_SIZE);
+	return false;
+}
+
+/*
+ * Mark refresh requests up to now as answered by this status report
+ *   Called with the report lock held, before the report's state is published
+ *   Returns whether any refresh callers are waiting for it
+ */
+static bool corsair_void_refresh_answered(struct corsair_void_drvdata *drvdata)
+{
+	unsigned long seq = READ_ONCE(drvdata->refresh_seq);
+
+	/* Only a waiting refresh dirties the sequence */
+	if (READ_ONCE(drvdata->refresh_done_seq) == seq)
+		return false;
+
+	smp_store_release(&drvdata->refresh_done_seq, seq);
+	return true;
+}
 
-		corsair_void_process_receiver(drvdata,
-					      FIELD_GET(CORSAIR_VOID_CAPACITY_MASK, data[2]),
-					      data[3], data[4]);
-	} else if (hid_report->id == CORSAIR_VOID_FIRMWARE_REPORT_ID) {
-		drvdata->fw_receiver_major = data[1];
-		drvdata->fw_receiver_minor = data[2];
-		drvdata->fw_headset_major = data[3];
-		drvdata->fw_headset_minor = data[4];
+/*
+ * Settle any request a report answers, once its state is visible
+ *   Shared by new and duplicate reports, as either can be the reply
+ */
+static void corsair_void_report_replied(struct corsair_void_drvdata *drvdata,
+					u8 report_id,
+					const struct corsair_void_state *state,
+					s64 latency_ns, bool refreshed)
+{
+	if (report_id == CORSAIR_VOID_STATUS_REPORT_ID) {
+		/* Only replies re-arm the poll, unprompted reports don't */
+		if (latency_ns) {
+			corsair_void_record_latency(drvdata, latency_ns);
+			corsair_void_status_replied(drvdata, state->connected);
+		}
+
+		if (refreshed)
+			wake_up_all(&drvdata->refresh_wait);
+	} else if (report_id == CORSAIR_VOID_FIRMWARE_REPORT_ID) {
+		/* A connected headset hasn't answered yet, so keep retrying */
+		if (drvdata->is_wired || !state->connected ||
+		    state->fw_headset_major || state->fw_headset_minor)
+			cancel_delayed_work(&drvdata->delayed_firmware_work);
+		complete_all(&drvdata->firmware_done);
+	}
+}
+
+/* Nothing changed, but a duplicate can still be the reply to a request */
+static void corsair_void_process_duplicate(struct corsair_void_drvdata *drvdata,
+					   u8 report_id, bool refreshed)
+{
+	struct corsair_void_state state;
+	s64 latency_ns;
+
+	corsair_void_stat_inc(drvdata, duplicate_reports);
+
+	if (report_id == CORSAIR_VOID_STATUS_REPORT_ID) {
+		corsair_void_stat_inc(drvdata, status_reports);
+		latency_ns = corsair_void_request_latency(&drvdata->status_request_ns);
+	} else {
+		corsair_void_stat_inc(drvdata, firmware_reports);
+		latency_ns = corsair_void_request_latency(&drvdata->firmware_request_ns);
+	}
+
+	corsair_void_get_state(drvdata, &state);
+	corsair_void_report_replied(drvdata, report_id, &state, latency_ns,
+				    refreshed);
+}
+
+/* Decode a report, from the device or injected through debugfs */
+static void corsair_void_process_report(struct corsair_void_drvdata *drvdata,
+					u8 *data, int size)
+{
+	struct corsair_void_state *state = &drvdata->state;
+	bool was_connected, was_mic_up, is_connected, is_mic_up;
+	struct corsair_void_state old_state, new_state;
+	struct corsair_void_status_report report = {};
+	struct hid_device *hid_dev = drvdata->hid_dev;
+	bool refreshed = false;
+	unsigned long flags;
+	s64 latency_ns = 0;
+	s64 battery_wait_ns = 0;
+	u8 report_id;
+
+	if (size < 1)
+		return;
+
+	/* Both known reports carry 4 bytes after the report ID */
+	report_id = data[0];
+	if ((report_id == CORSAIR_VOID_STATUS_REPORT_ID ||
+	     report_id == CORSAIR_VOID_FIRMWARE_REPORT_ID) &&
+	    size < CORSAIR_VOID_REPORT_SIZE)
+		return;
+
+	/* Duplicates are caught before the write section, readers never retry */
+	spin_lock_irqsave(&drvdata->report_lock, flags);
+	if (corsair_void_is_duplicate(drvdata, data, report_id)) {
+		refreshed = report_id == CORSAIR_VOID_STATUS_REPORT_ID &&
+			    corsair_void_refresh_answered(drvdata);
+		spin_unlock_irqrestore(&drvdata->report_lock, flags);
+		corsair_void_process_duplicate(drvdata, report_id, refreshed);
+		return;
+	}
+
+	/* Publish all changes from this report at once */
+	write_seqlock(&drvdata->state_lock);
+
+	old_state = *state;
+	was_connected = state->connected;
+	was_mic_up = state->mic_up;
+
+	/* Description of packets are documented at the top of this file */
+	if (report_id == CORSAIR_VOID_STATUS_REPORT_ID) {
+		corsair_void_stat_inc(drvdata, status_reports);
+		latency_ns = corsair_void_request_latency(&drvdata->status_request_ns);
+
+		corsair_void_decode_status(data, &report);
+		state->mic_up = report.mic_up;
+		state->power_button = report.power_button;
+		state->connected = corsair_void_decode_connected(report.connection_status,
+								 drvdata->is_wired);
+
+		corsair_void_process_receiver(drvdata, &report);
+		refreshed = corsair_void_refresh_answered(drvdata);
+	} else if (report_id == CORSAIR_VOID_FIRMWARE_REPORT_ID) {
+		corsair_void_stat_inc(drvdata, firmware_reports);
+		latency_ns = corsair_void_request_latency(&drvdata->firmware_request_ns);
+		state->fw_receiver_major = data[1];
+		state->fw_receiver_minor = data[2];
+
+		/* Without a headset to answer, keep any cached headset version */
+		if (data[3] || data[4]) {
+			state->fw_headset_major = data[3];
+			state->fw_headset_minor = data[4];
+		}
+	} else {
+		corsair_void_stat_inc(drvdata, other_reports);
 	}
 
 	/* Handle wireless headset connect / disconnect */
-	if ((was_connected != drvdata->connected) && !drvdata->is_wired) {
-		if (drvdata->connected)
+	if ((was_connected != state->connected) && !drvdata->is_wired) {
+		if (state->connected)
 			corsair_void_headset_connected(drvdata);
 		else
 			corsair_void_headset_disconnected(drvdata);
 	}
 
+	/*
+	 * Time how long the first battery reading took to arrive
+	 *   Checked after a connect restarts the timer, so a connect report
+	 *   carrying the battery closes out its own wait
+	 */
+	if (report_id == CORSAIR_VOID_STATUS_REPORT_ID &&
+	    state->battery_data.present && drvdata->battery_wait_ns) {
+		battery_wait_ns = ktime_get_ns() - drvdata->battery_wait_ns;
+		drvdata->battery_wait_ns = 0;
+	}
+
+	new_state = *state;
+	is_connected = state->connected;
+	is_mic_up = state->mic_up;
+	write_sequnlock(&drvdata->state_lock);
+	spin_unlock_irqrestore(&drvdata->report_lock, flags);
+
+	corsair_void_report_replied(drvdata, report_id, &new_state, latency_ns,
+				    refreshed);
+
+	if (event_device)
+		corsair_void_queue_events(drvdata, &old_state, &new_state);
+
+	/* Wake up anything polling the attributes, if they changed */
+	if (was_connected != is_connected)
+		sysfs_notify_dirent(drvdata->connected_kn);
+	if (was_mic_up != is_mic_up)
+		sysfs_notify_dirent(drvdata->mic_up_kn);
+
+	/* Input core drops events for unchanged states */
+	if (report_id == CORSAIR_VOID_STATUS_REPORT_ID) {
+		input_report_key(drvdata->input_dev,
+				 CORSAIR_VOID_POWER_BUTTON_KEY, report.power_button);
+		input_report_switch(drvdata->input_dev,
+				    CORSAIR_VOID_MIC_UP_SWITCH, is_mic_up);
+		input_sync(drvdata->input_dev);
+
+		trace_corsair_void_status_report(hid_dev->id, report.power_button,
+						 report.mic_up, report.capacity,
+						 report.connection_status,
+						 report.battery_status, latency_ns);
+		if (battery_wait_ns)
+			trace_corsair_void_first_battery(hid_dev->id,
+							 battery_wait_ns);
+	} else if (report_id == CORSAIR_VOID_FIRMWARE_REPORT_ID) {
+		trace_corsair_void_firmware_report(hid_dev->id, data[1], data[2],
+						   data[3], data[4], latency_ns);
+	}
+}
+
+static int corsair_void_raw_event(struct hid_device *hid_dev,
+				  struct hid_report *hid_report,
+				  u8 *data, int size)
+{
+	struct corsair_void_drvdata *drvdata = hid_get_drvdata(hid_dev);
+
+	corsair_void_capture_report(drvdata, data, size);
+	corsair_void_process_report(drvdata, data, size);
+
+	return 0;
+}
+
+#ifdef CONFIG_PM
+static int corsair_void_suspend(struct hid_device *hid_dev, pm_message_t message)
+{
+	struct corsair_void_drvdata *drvdata = hid_get_drvdata(hid_dev);
+
+	/*
+	 * Work handlers resume the device for their requests, so an autosuspend
+	 * must not wait for them, it'd deadlock with their runtime PM reference
+	 */
+	if (PMSG_IS_AUTO(message))
+		return 0;
+
+	/* Nothing can be sent while suspended, resume restarts the requests */
+	drvdata->system_suspended = true;
+	cancel_delayed_work_sync(&drvdata->delayed_status_work);
+	cancel_delayed_work_sync(&drvdata->delayed_firmware_work);
+	cancel_work_sync(&drvdata->sidetone_work);
+
+	return 0;
+}
+
+/*
+ * The headset may have changed while suspended, so don't wait for it to speak
+ *   Requests are queued rather than sent, as the interface is still resuming
+ */
+static void corsair_void_restart(struct corsair_void_drvdata *drvdata)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&drvdata->report_lock, flags);
+	drvdata->battery_wait_ns = ktime_get_ns();
+	drvdata->last_status[0] = 0;
+	drvdata->last_firmware[0] = 0;
+	spin_unlock_irqrestore(&drvdata->report_lock, flags);
+
+	WRITE_ONCE(drvdata->status_retries, CORSAIR_VOID_REQUEST_RETRIES);
+	mod_delayed_work(corsair_void_wq, &drvdata->delayed_status_work, 0);
+	if (!drvdata->lazy_firmware) {
+		WRITE_ONCE(drvdata->firmware_retries, CORSAIR_VOID_REQUEST_RETRIES);
+		mod_delayed_work(corsair_void_wq, &drvdata->delayed_firmware_work, 0);
+	}
+
+	/* Replay the last requested sidetone, the headset may have lost it */
+	WRITE_ONCE(drvdata->sidetone_stale, true);
+	if (corsair_void_is_connected(drvdata) &&
+	    READ_ONCE(drvdata->sidetone_target) >= 0)
+		queue_work(corsair_void_wq, &drvdata->sidetone_work);
+}
+
+/* Runtime resumes, including remote wakeups, have nothing to restart */
+static int corsair_void_resume(struct hid_device *hid_dev)
+{
+	struct corsair_void_drvdata *drvdata = hid_get_drvdata(hid_dev);
+
+	if (!drvdata->system_suspended)
+		return 0;
+
+	drvdata->system_suspended = false;
+	corsair_void_restart(drvdata);
+	return 0;
+}
+
+/* A reset loses the headset's settings however the device was suspended */
+static int corsair_void_reset_resume(struct hid_device *hid_dev)
+{
+	struct corsair_void_drvdata *drvdata = hid_get_drvdata(hid_dev);
+
+	drvdata->system_suspended = false;
+	corsair_void_restart(drvdata);
 	return 0;
 }
+#endif
+
+static const struct corsair_void_model corsair_void_wireless_model = {
+	.is_wired = false,
+	.sidetone_max = CORSAIR_VOID_SIDETONE_MAX_WIRELESS,
+	.sidetone_packet = corsair_void_sidetone_packet,
+	.sidetone_packet_size = sizeof(corsair_void_sidetone_packet),
+	.set_sidetone = corsair_void_set_sidetone_wireless,
+	.send_alert = corsair_void_send_alert_wireless,
+};
+
+/* Wired sidetone is a USB control transfer, and there's no known alert */
+static const struct corsair_void_model corsair_void_wired_model = {
+	.is_wired = true,
+	.sidetone_max = CORSAIR_VOID_SIDETONE_MAX_WIRED,
+	.set_sidetone = corsair_void_set_sidetone_wired,
+};
 
 static const struct hid_device_id corsair_void_devices[] = {
 	/* Corsair Void Wireless */
@@ -820,9 +2903,77 @@ static struct hid_driver corsair_void_driver = {
 	.probe = corsair_void_probe,
 	.remove = corsair_void_remove,
 	.raw_event = corsair_void_raw_event,
+#ifdef CONFIG_PM
+	.suspend = corsair_void_suspend,
+	.resume = corsair_void_resume,
+	.reset_resume = corsair_void_reset_resume,
+#endif
+	/*
+	 * Probe only touches per-device state, and the debugfs root created
+	 * before registering, so receivers can be brought up in parallel
+	 */
+	.driver = {
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
+	},
 };
 
-module_hid_driver(corsair_void_driver);
+static int __init corsair_void_init(void)
+{
+	int ret;
+
+	/*
+	 * Unbound, as none of the work cares which CPU it runs on
+	 *   Exposed in sysfs, so its CPU mask and priority can be tuned
+	 */
+	corsair_void_wq = alloc_workqueue("corsair_void", WQ_UNBOUND | WQ_SYSFS,
+					  wq_max_active);
+	if (!corsair_void_wq)
+		return -ENOMEM;
+
+	corsair_void_debugfs_root = debugfs_create_dir("hid-corsair-void", NULL);
+	debugfs_create_file("devices", 0444, corsair_void_debugfs_root, NULL,
+			    &corsair_void_devices_fops);
+
+	if (event_device) {
+		ret = misc_register(&corsair_void_events_miscdev);
+		if (ret)
+			goto failed_after_debugfs;
+
+		debugfs_create_file("events", 0444, corsair_void_debugfs_root,
+				    NULL, &corsair_void_events_stats_fops);
+	}
+
+	ret = hid_register_driver(&corsair_void_driver);
+	if (ret)
+		goto failed_after_misc;
+
+	return 0;
+
+failed_after_misc:
+	if (event_device)
+		misc_deregister(&corsair_void_events_miscdev);
+failed_after_debugfs:
+	debugfs_remove_recursive(corsair_void_debugfs_root);
+	destroy_workqueue(corsair_void_wq);
+	return ret;
+}
+
+static void __exit corsair_void_exit(void)
+{
+	hid_unregister_driver(&corsair_void_driver);
+	if (event_device)
+		misc_deregister(&corsair_void_events_miscdev);
+	debugfs_remove_recursive(corsair_void_debugfs_root);
+	destroy_workqueue(corsair_void_wq);
+}
+
+module_init(corsair_void_init);
+module_exit(corsair_void_exit);
+
+/* Built with make test, the suite runs when the module loads */
+#ifdef CORSAIR_VOID_KUNIT_TEST
+#include "hid-corsair-void-test.c"
+#endif
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("Stuart Hayhurst <stuart.a.hayhurst@gmail.com>");
@@ -0,0 +1,599 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ *  Benchmark harness for the Corsair Void driver, using an emulated receiver
+ *
+ *  Copyright (C) 2023-2024 Stuart Hayhurst
+ */
+
+/*
+ * A wireless receiver is created through /dev/uhid, answering status and
+ * firmware requests like a connected headset would. The driver must be loaded
+ * with allow_emulated=1 to bind it, and this must be run as root.
+ *
+ * Measured, from writing the report to seeing its effect:
+ *  - Report to battery uevent, alternating the battery level
+ *  - Report to sysfs_notify() on microphone_up, toggling the mic
+ *  - Sidetone write to the sidetone request reaching the receiver
+ *  - Report throughput, flooding status reports at a fixed rate
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <getopt.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/netlink.h>
+#include <linux/uhid.h>
+#include <sys/socket.h>
+
+#define CORSAIR_VOID_VENDOR_ID		0x1B1C
+#define CORSAIR_VOID_DEFAULT_PRODUCT	0x0A2B
+
+#define CORSAIR_VOID_STATUS_REQUEST_ID		0xC9
+#define CORSAIR_VOID_SIDETONE_REQUEST_ID	0xFF
+#define CORSAIR_VOID_STATUS_REPORT_ID		0x64
+#define CORSAIR_VOID_FIRMWARE_REPORT_ID		0x66
+
+#define CORSAIR_VOID_WIRELESS_CONNECTED		177
+#define CORSAIR_VOID_BATTERY_NORMAL		1
+#define CORSAIR_VOID_BATTERY_LOW		2
+
+#define BENCH_TIMEOUT_MS		2000
+#define BENCH_SETTLE_US			20000
+
+/* Vendor defined reports, matching what the driver sends and expects */
+static const uint8_t bench_rdesc[] = {
+	0x06, 0x00, 0xFF,	/* Usage Page (Vendor Defined 0xFF00) */
+	0x09, 0x01,		/* Usage (0x01) */
+	0xA1, 0x01,		/* Collection (Application) */
+	0x15, 0x00,		/*  Logical Minimum (0) */
+	0x26, 0xFF, 0x00,	/*  Logical Maximum (255) */
+	0x75, 0x08,		/*  Report Size (8) */
+	0x85, 0x64,		/*  Report ID (0x64), status */
+	0x95, 0x04,		/*  Report Count (4) */
+	0x09, 0x01,		/*  Usage (0x01) */
+	0x81, 0x02,		/*  Input (Data, Variable, Absolute) */
+	0x85, 0x66,		/*  Report ID (0x66), firmware */
+	0x95, 0x04,		/*  Report Count (4) */
+	0x09, 0x01,		/*  Usage (0x01) */
+	0x81, 0x02,		/*  Input (Data, Variable, Absolute) */
+	0x85, 0xC9,		/*  Report ID (0xC9), status request */
+	0x95, 0x01,		/*  Report Count (1) */
+	0x09, 0x01,		/*  Usage (0x01) */
+	0x91, 0x02,		/*  Output (Data, Variable, Absolute) */
+	0x85, 0xCA,		/*  Report ID (0xCA), alert */
+	0x95, 0x02,		/*  Report Count (2) */
+	0x09, 0x01,		/*  Usage (0x01) */
+	0x91, 0x02,		/*  Output (Data, Variable, Absolute) */
+	0x85, 0xFF,		/*  Report ID (0xFF), sidetone */
+	0x95, 0x0B,		/*  Report Count (11) */
+	0x09, 0x01,		/*  Usage (0x01) */
+	0xB1, 0x02,		/*  Feature (Data, Variable, Absolute) */
+	0xC0,			/* End Collection */
+};
+
+/* Emulated headset state, shared with the uhid thread */
+struct bench_receiver {
+	int fd;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool mic_up;
+	uint8_t capacity;
+	uint8_t battery_status;
+	uint64_t sidetone_ns;
+	unsigned long status_requests;
+	unsigned long firmware_requests;
+};
+
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int bench_write_event(struct bench_receiver *receiver,
+			     const struct uhid_event *ev)
+{
+	ssize_t ret = write(receiver->fd, ev, sizeof(*ev));
+
+	if (ret < 0)
+		return -errno;
+	return ret == sizeof(*ev) ? 0 : -EFAULT;
+}
+
+static int bench_send_input(struct bench_receiver *receiver,
+			    const uint8_t *data, size_t size)
+{
+	struct uhid_event ev = { .type = UHID_INPUT2 };
+
+	ev.u.input2.size = size;
+	memcpy(ev.u.input2.data, data, size);
+	return bench_write_event(receiver, &ev);
+}
+
+/* Called with the receiver lock held */
+static int bench_send_status(struct bench_receiver *receiver)
+{
+	const uint8_t report[] = {
+		CORSAIR_VOID_STATUS_REPORT_ID, 0,
+		(receiver->mic_up ? 0x80 : 0) | receiver->capacity,
+		CORSAIR_VOID_WIRELESS_CONNECTED, receiver->battery_status,
+	};
+
+	return bench_send_input(receiver, report, sizeof(report));
+}
+
+static int bench_send_firmware(struct bench_receiver *receiver)
+{
+	const uint8_t report[] = {
+		CORSAIR_VOID_FIRMWARE_REPORT_ID, 1, 2, 3, 4,
+	};
+
+	return bench_send_input(receiver, report, sizeof(report));
+}
+
+/* Answer the driver's requests, like a receiver with a connected headset */
+static void bench_handle_set_report(struct bench_receiver *receiver,
+				    const struct uhid_set_report_req *req)
+{
+	struct uhid_event reply = { .type = UHID_SET_REPORT_REPLY };
+
+	reply.u.set_report_reply.id = req->id;
+	reply.u.set_report_reply.err = 0;
+
+	pthread_mutex_lock(&receiver->lock);
+	bench_write_event(receiver, &reply);
+
+	if (req->rnum == CORSAIR_VOID_SIDETONE_REQUEST_ID) {
+		receiver->sidetone_ns = bench_now_ns();
+		pthread_cond_broadcast(&receiver->cond);
+	} else if (req->rnum == CORSAIR_VOID_STATUS_REQUEST_ID && req->size >= 2) {
+		if (req->data[1] == CORSAIR_VOID_STATUS_REPORT_ID) {
+			receiver->status_requests++;
+			bench_send_status(receiver);
+		} else if (req->data[1] == CORSAIR_VOID_FIRMWARE_REPORT_ID) {
+			receiver->firmware_requests++;
+			bench_send_firmware(receiver);
+		}
+	}
+	pthread_mutex_unlock(&receiver->lock);
+}
+
+static void *bench_uhid_thread(void *data)
+{
+	struct bench_receiver *receiver = data;
+	struct uhid_event ev, reply;
+
+	while (read(receiver->fd, &ev, sizeof(ev)) > 0) {
+		switch (ev.type) {
+		case UHID_SET_REPORT:
+			bench_handle_set_report(receiver, &ev.u.set_report);
+			break;
+		case UHID_GET_REPORT:
+			memset(&reply, 0, sizeof(reply));
+			reply.type = UHID_GET_REPORT_REPLY;
+			reply.u.get_report_reply.id = ev.u.get_report.id;
+			reply.u.get_report_reply.err = EIO;
+			pthread_mutex_lock(&receiver->lock);
+			bench_write_event(receiver, &reply);
+			pthread_mutex_unlock(&receiver->lock);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static int bench_create(struct bench_receiver *receiver, unsigned int product)
+{
+	struct uhid_event ev = { .type = UHID_CREATE2 };
+
+	snprintf((char *)ev.u.create2.name, sizeof(ev.u.create2.name),
+		 "Corsair Void Bench Receiver");
+	snprintf((char *)ev.u.create2.phys, sizeof(ev.u.create2.phys),
+		 "corsair-void-bench");
+	ev.u.create2.rd_size = sizeof(bench_rdesc);
+	ev.u.create2.bus = BUS_USB;
+	ev.u.create2.vendor = CORSAIR_VOID_VENDOR_ID;
+	ev.u.create2.product = product;
+	memcpy(ev.u.create2.rd_data, bench_rdesc, sizeof(bench_rdesc));
+
+	return bench_write_event(receiver, &ev);
+}
+
+/* Whether the receiver driver has bound a HID device */
+static bool bench_is_bound(const char *name)
+{
+	char path[PATH_MAX], target[PATH_MAX];
+	ssize_t len;
+
+	snprintf(path, sizeof(path), "/sys/bus/hid/devices/%s/driver", name);
+	len = readlink(path, target, sizeof(target) - 1);
+	if (len < 0)
+		return false;
+
+	target[len] = '\0';
+	return strstr(target, "/hid-corsair-void") != NULL;
+}
+
+/* Find the emulated receiver's HID device, skipping any that existed before */
+static int bench_find_device(unsigned int product, char **existing,
+			     size_t n_existing, char *name, size_t size)
+{
+	char pattern[32];
+	struct dirent *entry;
+	bool found = false;
+	size_t i;
+	DIR *dir;
+
+	snprintf(pattern, sizeof(pattern), "0003:%04X:%04X.*",
+		 CORSAIR_VOID_VENDOR_ID, product);
+
+	dir = opendir("/sys/bus/hid/devices");
+	if (!dir)
+		return -errno;
+
+	while (!found && (entry = readdir(dir))) {
+		if (fnmatch(pattern, entry->d_name, 0))
+			continue;
+
+		for (i = 0; i < n_existing; i++)
+			if (!strcmp(existing[i], entry->d_name))
+				break;
+		if (i < n_existing)
+			continue;
+
+		snprintf(name, size, "%s", entry->d_name);
+		found = true;
+	}
+
+	closedir(dir);
+	return found ? 0 : -ENOENT;
+}
+
+/* Remember the matching devices before creating ours */
+static size_t bench_list_devices(unsigned int product, char ***list)
+{
+	char pattern[32];
+	struct dirent *entry;
+	size_t count = 0;
+	DIR *dir;
+
+	*list = NULL;
+	snprintf(pattern, sizeof(pattern), "0003:%04X:%04X.*",
+		 CORSAIR_VOID_VENDOR_ID, product);
+
+	dir = opendir("/sys/bus/hid/devices");
+	if (!dir)
+		return 0;
+
+	while ((entry = readdir(dir))) {
+		if (fnmatch(pattern, entry->d_name, 0))
+			continue;
+
+		*list = realloc(*list, sizeof(**list) * (count + 1));
+		(*list)[count++] = strdup(entry->d_name);
+	}
+
+	closedir(dir);
+	return count;
+}
+
+static int bench_compare_ns(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void bench_print(const char *name, uint64_t *samples, size_t count)
+{
+	if (!count) {
+		printf("%-28s no samples\n", name);
+		return;
+	}
+
+	qsort(samples, count, sizeof(*samples), bench_compare_ns);
+	printf("%-28s min %8.1fus  median %8.1fus  p99 %8.1fus  max %8.1fus\n",
+	       name, samples[0] / 1000.0, samples[count / 2] / 1000.0,
+	       samples[(count * 99) / 100] / 1000.0, samples[count - 1] / 1000.0);
+}
+
+/* Report to the battery's change uevent, alternating the battery level */
+static size_t bench_uevent(struct bench_receiver *receiver, const char *name,
+			   uint64_t *samples, size_t count)
+{
+	struct sockaddr_nl addr = {
+		.nl_family = AF_NETLINK,
+		.nl_groups = 1,
+	};
+	char buf[8192], match[NAME_MAX + 32];
+	struct pollfd pfd;
+	size_t done = 0, i;
+	uint64_t start_ns;
+	ssize_t len;
+	int sock;
+
+	sock = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC,
+		      NETLINK_KOBJECT_UEVENT);
+	if (sock < 0 || bind(sock, (struct sockaddr *)&addr, sizeof(addr))) {
+		perror("uevent socket");
+		if (sock >= 0)
+			close(sock);
+		return 0;
+	}
+
+	/* Change uevents from our receiver's power supply */
+	snprintf(match, sizeof(match), "/%s/power_supply/", name);
+	pfd.fd = sock;
+	pfd.events = POLLIN;
+
+	for (i = 0; i < count; i++) {
+		pthread_mutex_lock(&receiver->lock);
+		receiver->battery_status = receiver->battery_status ==
+					   CORSAIR_VOID_BATTERY_NORMAL ?
+					   CORSAIR_VOID_BATTERY_LOW :
+					   CORSAIR_VOID_BATTERY_NORMAL;
+		start_ns = bench_now_ns();
+		bench_send_status(receiver);
+		pthread_mutex_unlock(&receiver->lock);
+
+		while (poll(&pfd, 1, BENCH_TIMEOUT_MS) > 0) {
+			len = recv(sock, buf, sizeof(buf) - 1, 0);
+			if (len <= 0)
+				break;
+
+			buf[len] = '\0';
+			if (!strncmp(buf, "change@", 7) && strstr(buf, match)) {
+				samples[done++] = bench_now_ns() - start_ns;
+				break;
+			}
+		}
+	}
+
+	close(sock);
+	return done;
+}
+
+static int bench_open_attr(const char *name, const char *attr, int flags)
+{
+	char path[PATH_MAX];
+
+	snprintf(path, sizeof(path), "/sys/bus/hid/devices/%s/%s", name, attr);
+	return open(path, flags | O_CLOEXEC);
+}
+
+/* Report to sysfs_notify() on microphone_up, toggling the mic */
+static size_t bench_sysfs_notify(struct bench_receiver *receiver,
+				 const char *name, uint64_t *samples,
+				 size_t count)
+{
+	struct pollfd pfd = { .events = POLLPRI | POLLERR };
+	size_t done = 0, i;
+	uint64_t start_ns;
+	char buf[16];
+
+	pfd.fd = bench_open_attr(name, "microphone_up", O_RDONLY);
+	if (pfd.fd < 0) {
+		perror("microphone_up");
+		return 0;
+	}
+
+	for (i = 0; i < count; i++) {
+		/* Reading arms the next notification */
+		if (pread(pfd.fd, buf, sizeof(buf), 0) < 0)
+			break;
+
+		pthread_mutex_lock(&receiver->lock);
+		receiver->mic_up = !receiver->mic_up;
+		start_ns = bench_now_ns();
+		bench_send_status(receiver);
+		pthread_mutex_unlock(&receiver->lock);
+
+		if (poll(&pfd, 1, BENCH_TIMEOUT_MS) > 0)
+			samples[done++] = bench_now_ns() - start_ns;
+	}
+
+	close(pfd.fd);
+	return done;
+}
+
+/* Sidetone write to the request reaching the receiver */
+static size_t bench_sidetone(struct bench_receiver *receiver, const char *name,
+			     uint64_t *samples, size_t count)
+{
+	struct timespec deadline;
+	size_t done = 0, i;
+	uint64_t start_ns;
+	char buf[16];
+	int fd, len;
+
+	fd = bench_open_attr(name, "set_sidetone", O_WRONLY);
+	if (fd < 0) {
+		perror("set_sidetone");
+		return 0;
+	}
+
+	for (i = 0; i < count; i++) {
+		len = snprintf(buf, sizeof(buf), "%d\n", i % 2 ? 20 : 40);
+
+		pthread_mutex_lock(&receiver->lock);
+		receiver->sidetone_ns = 0;
+		pthread_mutex_unlock(&receiver->lock);
+
+		start_ns = bench_now_ns();
+		if (pwrite(fd, buf, len, 0) != len) {
+			perror("set_sidetone");
+			break;
+		}
+
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += BENCH_TIMEOUT_MS / 1000;
+
+		pthread_mutex_lock(&receiver->lock);
+		while (!receiver->sidetone_ns &&
+		       !pthread_cond_timedwait(&receiver->cond, &receiver->lock,
+					       &deadline))
+			;
+		if (receiver->sidetone_ns)
+			samples[done++] = receiver->sidetone_ns - start_ns;
+		pthread_mutex_unlock(&receiver->lock);
+	}
+
+	close(fd);
+	return done;
+}
+
+/* Flood status reports at a fixed rate, reporting what was achieved */
+static void bench_flood(struct bench_receiver *receiver, unsigned int rate,
+			unsigned int seconds)
+{
+	uint64_t interval_ns = 1000000000ULL / rate, start_ns, next_ns;
+	unsigned long sent = 0, failed = 0, total = (unsigned long)rate * seconds;
+	struct timespec ts;
+
+	start_ns = bench_now_ns();
+	next_ns = start_ns;
+	while (sent + failed < total) {
+		pthread_mutex_lock(&receiver->lock);
+		if (bench_send_status(receiver))
+			failed++;
+		else
+			sent++;
+		pthread_mutex_unlock(&receiver->lock);
+
+		next_ns += interval_ns;
+		ts.tv_sec = next_ns / 1000000000ULL;
+		ts.tv_nsec = next_ns % 1000000000ULL;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+	}
+
+	printf("%-28s %lu sent, %lu failed, %.0f reports/s\n", "Status report flood",
+	       sent, failed, sent / ((bench_now_ns() - start_ns) / 1e9));
+}
+
+static void bench_usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s [-p product] [-n samples] [-r rate] [-d seconds]\n"
+		"  -p  Wireless receiver product ID, in hex (default %04x)\n"
+		"  -n  Samples for each latency measurement (default 100)\n"
+		"  -r  Status reports per second while flooding (default 1000)\n"
+		"  -d  Seconds to flood for, 0 to skip it (default 5)\n",
+		prog, CORSAIR_VOID_DEFAULT_PRODUCT);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int product = CORSAIR_VOID_DEFAULT_PRODUCT;
+	unsigned int rate = 1000, seconds = 5;
+	struct bench_receiver receiver = {
+		.lock = PTHREAD_MUTEX_INITIALIZER,
+		.cond = PTHREAD_COND_INITIALIZER,
+		.capacity = 80,
+		.battery_status = CORSAIR_VOID_BATTERY_NORMAL,
+	};
+	struct uhid_event destroy = { .type = UHID_DESTROY };
+	size_t count = 100, n_existing, done;
+	char name[NAME_MAX + 1], **existing;
+	uint64_t *samples;
+	pthread_t thread;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "p:n:r:d:h")) != -1) {
+		switch (opt) {
+		case 'p':
+			product = strtoul(optarg, NULL, 16);
+			break;
+		case 'n':
+			count = strtoul(optarg, NULL, 10);
+			break;
+		case 'r':
+			rate = strtoul(optarg, NULL, 10);
+			break;
+		case 'd':
+			seconds = strtoul(optarg, NULL, 10);
+			break;
+		default:
+			bench_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (!count || !rate) {
+		bench_usage(argv[0]);
+		return 1;
+	}
+
+	samples = calloc(count, sizeof(*samples));
+	if (!samples)
+		return 1;
+
+	receiver.fd = open("/dev/uhid", O_RDWR | O_CLOEXEC);
+	if (receiver.fd < 0) {
+		perror("/dev/uhid");
+		return 1;
+	}
+
+	n_existing = bench_list_devices(product, &existing);
+	if (bench_create(&receiver, product)) {
+		perror("UHID_CREATE2");
+		return 1;
+	}
+	pthread_create(&thread, NULL, bench_uhid_thread, &receiver);
+
+	/* Wait for the driver to bind, and for the battery to be registered */
+	for (i = 0; i < BENCH_TIMEOUT_MS / 10; i++) {
+		if (!bench_find_device(product, existing, n_existing, name,
+				       sizeof(name)) && bench_is_bound(name))
+			break;
+		usleep(10000);
+	}
+	if (i == BENCH_TIMEOUT_MS / 10) {
+		fprintf(stderr, "Driver didn't bind, is it loaded with allow_emulated=1?\n");
+		bench_write_event(&receiver, &destroy);
+		return 1;
+	}
+
+	pthread_mutex_lock(&receiver.lock);
+	bench_send_status(&receiver);
+	pthread_mutex_unlock(&receiver.lock);
+	usleep(BENCH_SETTLE_US * 10);
+
+	printf("Emulated receiver %s, %zu samples each\n", name, count);
+
+	done = bench_uevent(&receiver, name, samples, count);
+	bench_print("Report to uevent", samples, done);
+
+	done = bench_sysfs_notify(&receiver, name, samples, count);
+	bench_print("Report to sysfs_notify", samples, done);
+
+	done = bench_sidetone(&receiver, name, samples, count);
+	bench_print("Sidetone write to request", samples, done);
+
+	if (seconds)
+		bench_flood(&receiver, rate, seconds);
+
+	pthread_mutex_lock(&receiver.lock);
+	printf("%-28s %lu status, %lu firmware\n", "Requests answered",
+	       receiver.status_requests, receiver.firmware_requests);
+	bench_write_event(&receiver, &destroy);
+	pthread_mutex_unlock(&receiver.lock);
+
+	close(receiver.fd);
+	return 0;
+}